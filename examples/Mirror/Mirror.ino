@@ -0,0 +1,93 @@
+/*
+ * nDisplay mirror
+ *
+ * Encodes every frame of the built-in effects with CDisplayMirror and reports
+ * the bytes per frame for each effect. To mirror a real panel, pass the UART
+ * (e.g. Serial1) instead of the counting sink and feed the received bytes to
+ * CMirrorDecoder::Decode on the remote side. CMirrorDecoder has no Arduino
+ * dependencies and can be built into a host application as is.
+ */
+
+#include <nDisplay.h>
+#include <nDisplayMirror.h>
+
+#define UNIT_COUNT  8
+
+// Discards the stream, the mirror keeps the byte count
+class CountingSink : public Print
+{
+    public:
+    size_t write(uint8_t byte) override
+    {
+        (void)byte;
+        return 1;
+    }
+};
+
+static CDisplay s_display(UNIT_COUNT);
+static CountingSink s_sink;
+static CDisplayMirror s_mirror(s_display, s_sink);
+static uint32_t s_frame_count;
+
+// Called by the effects between frames
+static void MirrorDelay(uint32_t delay_ms)
+{
+    s_mirror.Update();
+    s_frame_count++;
+    delay(delay_ms);
+}
+
+static void Report(const __FlashStringHelper* name, const uint32_t byte_start, const uint32_t frame_start)
+{
+    uint32_t frame_count = s_frame_count - frame_start;
+
+    Serial.print(name);
+    Serial.print(F(" frames="));
+    Serial.print(frame_count);
+    Serial.print(F(" bytes/frame="));
+    Serial.println(static_cast<float>(s_mirror.GetByteCount() - byte_start) / frame_count);
+}
+
+
+void setup(void)
+{
+    uint32_t byte_start;
+    uint32_t frame_start;
+
+    Serial.begin(115200);
+    s_display.SetCallbackDelay(MirrorDelay);
+    s_display.SetDisplayValue("12:34:56");
+    s_mirror.Update(); // Initial keyframe
+
+    byte_start = s_mirror.GetByteCount();
+    frame_start = s_frame_count;
+    s_display.EffectScroll(F("HELLO WORLD "), CDisplay::Direction::LEFT, 0);
+    Report(F("EffectScroll"), byte_start, frame_start);
+
+    byte_start = s_mirror.GetByteCount();
+    frame_start = s_frame_count;
+    s_display.EffectSlotMachine(0);
+    Report(F("EffectSlotMachine"), byte_start, frame_start);
+
+    byte_start = s_mirror.GetByteCount();
+    frame_start = s_frame_count;
+    s_display.EffectStrobe(10, 0);
+    Report(F("EffectStrobe"), byte_start, frame_start);
+
+    byte_start = s_mirror.GetByteCount();
+    frame_start = s_frame_count;
+    s_display.FadeDisplayLevel(0, 500);
+
+    while (s_display.UpdateFade(20))
+    {
+        MirrorDelay(20);
+    }
+
+    Report(F("FadeDisplayLevel"), byte_start, frame_start);
+}
+
+
+void loop(void)
+{
+    // empty
+}
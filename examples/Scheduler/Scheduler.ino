@@ -0,0 +1,103 @@
+/*
+ * nDisplay scheduler
+ *
+ * Runs a scrolling region, a strobing region and a periodic sensor task
+ * together on one CScheduler, then reports latency and jitter for each task.
+ * Blocking effects and prompts also yield to the scheduler between frames, and
+ * prompts time out on the scheduler clock. Define VIRTUAL_CLOCK to run on
+ * simulated time, where the idle callback advances the clock to the next
+ * deadline; extras/test/scheduler.cpp drives the same hooks on a host build.
+ */
+
+#include <nDisplay.h>
+#include <nDisplayRegion.h>
+#include <nScheduler.h>
+
+//#define VIRTUAL_CLOCK
+
+#define UNIT_COUNT  8
+
+static CScheduler s_scheduler(4);
+static CDisplay s_display(UNIT_COUNT);
+static CDisplayRegion s_label(s_display, 0, 4);
+static CDisplayRegion s_status(s_display, 4, 4);
+
+#ifdef VIRTUAL_CLOCK
+static uint32_t s_time;
+
+static uint32_t VirtualTime(void)
+{
+    return s_time;
+}
+
+static void VirtualIdle(uint32_t delay_ms)
+{
+    s_time += delay_ms;
+}
+#endif
+
+static uint32_t SensorTask(void* context)
+{
+    (void)context;
+    analogRead(A0);
+    return 20; // Run every 20 ms
+}
+
+static void SchedulerDelay(uint32_t delay_ms)
+{
+    s_scheduler.Delay(delay_ms);
+}
+
+static uint32_t SchedulerTime(void)
+{
+    return s_scheduler.GetTime();
+}
+
+static void Report(const __FlashStringHelper* name, const uint8_t task)
+{
+    CScheduler::TaskStats stats = s_scheduler.GetTaskStats(task);
+
+    Serial.print(name);
+    Serial.print(F(" runs="));
+    Serial.print(stats.run_count);
+    Serial.print(F(" latency_avg="));
+    Serial.print((stats.run_count > 0) ? (stats.latency_sum / stats.run_count) : 0);
+    Serial.print(F(" latency_max="));
+    Serial.print(stats.latency_max);
+    Serial.print(F(" jitter="));
+    Serial.println(stats.latency_max - stats.latency_min);
+}
+
+
+void setup(void)
+{
+    Serial.begin(115200);
+
+#ifdef VIRTUAL_CLOCK
+    s_scheduler.SetClock(VirtualTime);
+    s_scheduler.SetCallbackIdle(VirtualIdle);
+#endif
+
+    // Effects and prompts yield to the scheduler between frames
+    s_display.SetCallbackDelay(SchedulerDelay);
+    s_display.SetCallbackTime(SchedulerTime);
+
+    s_label.EffectScroll("SCHEDULER   ", CDisplay::Direction::LEFT, 150);
+    uint8_t label_task = s_scheduler.AddTask(CDisplayRegion::Task, &s_label, 150);
+    s_status.SetValue(1234UL);
+    s_status.EffectStrobe(20, 40);
+    uint8_t status_task = s_scheduler.AddTask(CDisplayRegion::Task, &s_status, 40);
+    uint8_t sensor_task = s_scheduler.AddTask(SensorTask);
+
+    s_scheduler.Delay(2000);
+
+    Report(F("label"), label_task);
+    Report(F("status"), status_task);
+    Report(F("sensor"), sensor_task);
+}
+
+
+void loop(void)
+{
+    s_scheduler.Delay(1000);
+}
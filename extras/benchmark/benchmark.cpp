@@ -0,0 +1,644 @@
+/*
+ * nDisplay host benchmark
+ *
+ * Reports ns/op and heap allocations/op for the public CDisplay methods at 4,
+ * 8, 32 and 255 units and compares them against a stored baseline. GetUnit*
+ * times the five GetUnit getters together.
+ *
+ *   ndisplay_benchmark [--baseline FILE] [--threshold PERCENT] [--update]
+ *
+ * A result fails when its ns/op exceeds the baseline by more than PERCENT
+ * (also settable through NDISPLAY_BENCHMARK_THRESHOLD) plus THRESHOLD_NS, or
+ * when it makes more allocations per op than the baseline. --update rewrites
+ * the baseline file with the current results instead of comparing. The
+ * baseline is recorded from a Release build.
+ *
+ * Each benchmark is timed for N and 2N operations and the difference is
+ * used, so fixed setup cost (prompt titles, scrolling in, strobe) cancels
+ * out. N and 2N runs are interleaved and the median difference is used.
+ * delay() runs on the shim's virtual clock and costs nothing.
+ */
+
+#include <nDisplay.h>
+#include <HostAllocation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifndef NDISPLAY_BENCHMARK_BASELINE
+#define NDISPLAY_BENCHMARK_BASELINE "baseline.txt"
+#endif
+
+#define REPETITION          15
+#define THRESHOLD_PERCENT   100
+#define THRESHOLD_NS        10      // Timer noise allowance for ns-scale operations
+
+//---------------------------------------------------------------------
+// Scripted input for prompt benchmarks
+//---------------------------------------------------------------------
+
+static uint32_t s_input_remaining;
+static bool s_input_select;
+
+struct ScriptInput
+{
+    static bool IsIncrement(CDisplay& display)
+    {
+        (void)display;
+        return true;
+    }
+
+    static bool IsUpdate(CDisplay& display)
+    {
+        (void)display;
+
+        if (s_input_remaining > 0)
+        {
+            s_input_remaining--;
+            return true;
+        }
+
+        return false;
+    }
+
+    static bool IsSelect(CDisplay& display)
+    {
+        (void)display;
+
+        // Press once after the scripted updates, then release
+        if ((s_input_remaining == 0) && !s_input_select)
+        {
+            s_input_select = true;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+//---------------------------------------------------------------------
+// Operations
+//---------------------------------------------------------------------
+
+typedef void (*Operation)(CDisplay& display, const uint32_t count);
+
+struct Benchmark
+{
+    const char* name;
+    Operation operation;
+    uint32_t iteration;
+};
+
+static char s_buffer[256];
+static volatile uint32_t s_sink; // Keeps getter results alive
+
+static void OpSetDisplayValueString(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetDisplayValue(s_buffer);
+    }
+}
+
+static void OpSetDisplayValueNumber(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetDisplayValue(index * 7919); // Uses itoa
+    }
+}
+
+static void OpGetDisplayValue(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.GetDisplayValue(s_buffer);
+    }
+}
+
+static void OpSetUnitValue(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetUnitValue(index % unit_count, '0' + (index % 10));
+    }
+}
+
+static void OpSetDisplayValueFlash(CDisplay& display, const uint32_t count)
+{
+    const __FlashStringHelper* string = reinterpret_cast<const __FlashStringHelper*>(s_buffer);
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetDisplayValue(string);
+    }
+}
+
+static void OpSetUnitIndicator(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetUnitIndicator(index % unit_count, index % 2);
+    }
+}
+
+static void OpSetUnitBrightness(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetUnitBrightness(index % unit_count, static_cast<CDisplay::Brightness>(index % 9));
+    }
+}
+
+static void OpSetUnitLevel(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetUnitLevel(index % unit_count, index);
+    }
+}
+
+static void OpGetUnit(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+    uint32_t sum = 0;
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        type_unit unit = index % unit_count;
+
+        sum += display.GetUnitValue(unit);
+        sum += display.GetUnitIndicator(unit);
+        sum += static_cast<uint8_t>(display.GetUnitBrightness(unit));
+        sum += display.GetUnitLevel(unit);
+        sum += display.GetUnitDuty(unit);
+    }
+
+    s_sink = sum;
+}
+
+static void OpSetDisplayIndicator(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetDisplayIndicator(index % 2);
+    }
+}
+
+static void OpSetDisplayBrightness(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetDisplayBrightness(static_cast<CDisplay::Brightness>(index % 9));
+    }
+}
+
+static void OpFillRangeValue(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.FillRangeValue(0, display.GetUnitCount(), '0' + (index % 10));
+    }
+}
+
+static void OpSetRangeValue(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.SetRangeValue(0, s_buffer + (index % 10), display.GetUnitCount());
+    }
+}
+
+static void OpShiftRangeValue(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.ShiftRangeValue(0, display.GetUnitCount(), CDisplay::Direction::RIGHT, s_buffer);
+    }
+}
+
+static void OpRotateDisplayValue(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.RotateDisplayValue(CDisplay::Direction::LEFT);
+    }
+}
+
+static void OpEffectScroll(CDisplay& display, const uint32_t count)
+{
+    std::string s(100, 'A'); // Length is a type_unit
+
+    for (uint32_t index = 0; index < count; index += s.length())
+    {
+        display.EffectScroll(s.c_str(), CDisplay::Direction::LEFT, 0); // One frame per character
+    }
+}
+
+static void OpEffectScrollNumber(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index += display.GetUnitCount())
+    {
+        display.EffectScroll(index * 7919, CDisplay::Direction::LEFT, 0); // One frame per unit
+    }
+}
+
+static void OpEffectStrobe(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index += 2)
+    {
+        display.EffectStrobe(2, 0); // Two frames per call
+    }
+}
+
+static void OpEffectSlotMachine(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.EffectSlotMachine(0); // One complete run
+    }
+}
+
+static void OpFadeUnitLevel(CDisplay& display, const uint32_t count)
+{
+    type_unit unit_count = display.GetUnitCount();
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.FadeUnitLevel(index % unit_count, index, 1000);
+    }
+}
+
+static void OpUpdateFade(CDisplay& display, const uint32_t count)
+{
+    display.SetDisplayLevel(0);
+    display.FadeDisplayLevel(255, 0xFFFF); // Every unit in transition
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.UpdateFade(1);
+    }
+}
+
+static void OpPushPopOverlay(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.PushOverlay();
+        display.PopOverlay();
+    }
+}
+
+static void RunFlush(CDisplay& display, const uint32_t count, const bool mixed)
+{
+    display.PushOverlay();
+
+    for (type_unit unit = 0; mixed && (unit < display.GetUnitCount()); unit++)
+    {
+        display.SetOverlayMask(unit, unit % 2); // Every block composited per unit
+    }
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        display.Flush();
+    }
+
+    display.PopOverlay();
+}
+
+static void OpFlushOpaque(CDisplay& display, const uint32_t count)
+{
+    RunFlush(display, count, false);
+}
+
+static void OpFlushMixed(CDisplay& display, const uint32_t count)
+{
+    RunFlush(display, count, true);
+}
+
+static void RunPromptSelect(CDisplay& display, const uint32_t step_count)
+{
+    const __FlashStringHelper* const item[] =
+    {
+        reinterpret_cast<const __FlashStringHelper*>(s_buffer),
+        reinterpret_cast<const __FlashStringHelper*>(s_buffer),
+    };
+
+    CDisplay::PromptSelectStruct prompt;
+    prompt.item_count = 2;
+    prompt.item_array = item;
+
+    s_input_remaining = step_count + 1; // One update is cleared before input loop
+    s_input_select = false;
+    display.PromptSelect<ScriptInput>(prompt);
+}
+
+static void OpPromptSelectStep(CDisplay& display, const uint32_t count)
+{
+    RunPromptSelect(display, count); // One input step per update
+}
+
+static void OpPromptSelectCall(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        RunPromptSelect(display, 4); // Whole prompt including setup
+    }
+}
+
+static void RunPromptValue(CDisplay& display, const uint32_t step_count)
+{
+    static const type_unit position[] = {0};
+    static const uint8_t digit_count[] = {2};
+    static const type_item lower_limit[] = {0};
+    static const type_item upper_limit[] = {99};
+    type_item value[] = {0};
+
+    CDisplay::PromptValueStruct prompt;
+    prompt.item_count = 1;
+    prompt.item_position = position;
+    prompt.item_digit_count = digit_count;
+    prompt.item_lower_limit = lower_limit;
+    prompt.item_upper_limit = upper_limit;
+    prompt.item_value = value;
+    prompt.initial_display = " ";
+
+    s_input_remaining = step_count + 1; // One update is cleared before input loop
+    s_input_select = false;
+    display.PromptValue<ScriptInput>(prompt);
+}
+
+static void OpPromptValueStep(CDisplay& display, const uint32_t count)
+{
+    RunPromptValue(display, count); // One input step per update
+}
+
+static void OpPromptValueCall(CDisplay& display, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        RunPromptValue(display, 4); // Whole prompt including setup
+    }
+}
+
+static const Benchmark s_benchmark[] =
+{
+    {"SetDisplayValue(char*)", OpSetDisplayValueString, 20000},
+    {"SetDisplayValue(uint32)", OpSetDisplayValueNumber, 20000},
+    {"SetDisplayValue(F)", OpSetDisplayValueFlash, 20000},
+    {"GetDisplayValue", OpGetDisplayValue, 20000},
+    {"SetUnitValue", OpSetUnitValue, 200000},
+    {"SetUnitIndicator", OpSetUnitIndicator, 200000},
+    {"SetUnitBrightness", OpSetUnitBrightness, 200000},
+    {"SetUnitLevel", OpSetUnitLevel, 200000},
+    {"GetUnit*", OpGetUnit, 200000},
+    {"SetDisplayIndicator", OpSetDisplayIndicator, 20000},
+    {"SetDisplayBrightness", OpSetDisplayBrightness, 20000},
+    {"SetRangeValue", OpSetRangeValue, 20000},
+    {"FillRangeValue", OpFillRangeValue, 20000},
+    {"ShiftRangeValue", OpShiftRangeValue, 20000},
+    {"RotateDisplayValue", OpRotateDisplayValue, 20000},
+    {"FadeUnitLevel", OpFadeUnitLevel, 20000},
+    {"UpdateFade(display)", OpUpdateFade, 20000},
+    {"PushOverlay+PopOverlay", OpPushPopOverlay, 20000},
+    {"Flush(opaque)", OpFlushOpaque, 20000},
+    {"Flush(mixed)", OpFlushMixed, 20000},
+    {"EffectScroll/frame", OpEffectScroll, 20000},
+    {"EffectScroll(uint32)/frame", OpEffectScrollNumber, 20000},
+    {"EffectStrobe/frame", OpEffectStrobe, 20000},
+    {"EffectSlotMachine/run", OpEffectSlotMachine, 4},
+    {"PromptSelect/step", OpPromptSelectStep, 20000},
+    {"PromptSelect/call", OpPromptSelectCall, 20},
+    {"PromptValue/step", OpPromptValueStep, 20000},
+    {"PromptValue/call", OpPromptValueCall, 20},
+};
+
+static const uint8_t s_unit_count[] = {4, 8, 32, 255};
+
+//---------------------------------------------------------------------
+// Measurement
+//---------------------------------------------------------------------
+
+struct Result
+{
+    double ns_per_op;
+    double allocation_per_op;
+};
+
+static double Measure(CDisplay& display, const Benchmark& benchmark, const uint32_t count, uint64_t& allocation)
+{
+    display.SetDisplayValue(s_buffer);
+
+    uint64_t allocation_start = HostAllocationCount();
+    auto time_start = std::chrono::steady_clock::now();
+
+    benchmark.operation(display, count);
+
+    auto time_end = std::chrono::steady_clock::now();
+
+    allocation = HostAllocationCount() - allocation_start;
+    return std::chrono::duration<double, std::nano>(time_end - time_start).count();
+}
+
+
+static Result Run(const Benchmark& benchmark, const uint8_t unit_count)
+{
+    CDisplay display(unit_count);
+    double difference[REPETITION];
+    uint64_t allocation_single;
+    uint64_t allocation_double;
+    Result result;
+
+    // Interleave N and 2N runs and take the median difference, so a noisy
+    // repetition cannot skew either side on its own
+    for (uint8_t repetition = 0; repetition < REPETITION; repetition++)
+    {
+        double ns_single = Measure(display, benchmark, benchmark.iteration, allocation_single);
+        double ns_double = Measure(display, benchmark, 2 * benchmark.iteration, allocation_double);
+
+        difference[repetition] = ns_double - ns_single;
+    }
+
+    std::sort(difference, difference + REPETITION);
+
+    result.ns_per_op = std::max(0.0, difference[REPETITION / 2] / benchmark.iteration);
+    result.allocation_per_op = (allocation_double > allocation_single) ?
+        (static_cast<double>(allocation_double - allocation_single) / benchmark.iteration) : 0;
+    return result;
+}
+
+//---------------------------------------------------------------------
+// Baseline
+//---------------------------------------------------------------------
+
+typedef std::map<std::string, Result> Baseline;
+
+static std::string Key(const char* name, const uint8_t unit_count)
+{
+    return std::string(name) + " " + std::to_string(unit_count);
+}
+
+static bool ReadBaseline(const char* path, Baseline& baseline)
+{
+    FILE* file = fopen(path, "r");
+    char line[256];
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        char name[128];
+        unsigned unit_count;
+        Result result;
+
+        if ((line[0] == '#') ||
+            (sscanf(line, "%127s %u %lf %lf", name, &unit_count, &result.ns_per_op, &result.allocation_per_op) != 4))
+        {
+            continue;
+        }
+
+        baseline[Key(name, unit_count)] = result;
+    }
+
+    fclose(file);
+    return true;
+}
+
+static bool WriteBaseline(const char* path, const std::vector<std::pair<std::string, Result>>& results)
+{
+    FILE* file = fopen(path, "w");
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    fprintf(file, "# name units ns_per_op allocations_per_op\n");
+
+    for (const auto& entry : results)
+    {
+        fprintf(file, "%s %.1f %.3f\n", entry.first.c_str(), entry.second.ns_per_op, entry.second.allocation_per_op);
+    }
+
+    fclose(file);
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* baseline_path = NDISPLAY_BENCHMARK_BASELINE;
+    double threshold = THRESHOLD_PERCENT;
+    bool update = false;
+    bool regression = false;
+    Baseline baseline;
+    std::vector<std::pair<std::string, Result>> results;
+
+    if (const char* value = getenv("NDISPLAY_BENCHMARK_THRESHOLD"))
+    {
+        threshold = atof(value);
+    }
+
+    for (int index = 1; index < argc; index++)
+    {
+        std::string arg = argv[index];
+
+        if ((arg == "--baseline") && (index + 1 < argc))
+        {
+            baseline_path = argv[++index];
+        }
+        else if ((arg == "--threshold") && (index + 1 < argc))
+        {
+            threshold = atof(argv[++index]);
+        }
+        else if (arg == "--update")
+        {
+            update = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--baseline FILE] [--threshold PERCENT] [--update]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!update && !ReadBaseline(baseline_path, baseline))
+    {
+        fprintf(stderr, "cannot read baseline %s\n", baseline_path);
+        return 2;
+    }
+
+    for (uint16_t index = 0; index < sizeof(s_buffer); index++)
+    {
+        s_buffer[index] = '0' + (index % 10);
+    }
+
+    printf("%-26s %5s %12s %10s %12s  %s\n", "benchmark", "units", "ns/op", "allocs/op", "baseline", "result");
+
+    for (uint8_t unit_column = 0; unit_column < sizeof(s_unit_count); unit_column++)
+    {
+        for (const Benchmark& benchmark : s_benchmark)
+        {
+            uint8_t unit_count = s_unit_count[unit_column];
+            std::string key = Key(benchmark.name, unit_count);
+            Result result = Run(benchmark, unit_count);
+            const char* status = "";
+
+            results.emplace_back(key, result);
+            printf("%-26s %5u %12.1f %10.3f", benchmark.name, unit_count, result.ns_per_op, result.allocation_per_op);
+
+            if (!update)
+            {
+                auto entry = baseline.find(key);
+
+                if (entry == baseline.end())
+                {
+                    printf(" %12s", "-");
+                    status = "NEW";
+                }
+                else
+                {
+                    const Result& expected = entry->second;
+                    bool slower = (result.ns_per_op > expected.ns_per_op * (1 + threshold / 100) + THRESHOLD_NS);
+                    bool allocating = (result.allocation_per_op > expected.allocation_per_op + 0.0005);
+
+                    printf(" %12.1f", expected.ns_per_op);
+                    status = slower ? "FAIL (time)" : (allocating ? "FAIL (allocations)" : "PASS");
+                    regression |= (slower || allocating);
+                }
+            }
+
+            printf("  %s\n", status);
+        }
+    }
+
+    if (update)
+    {
+        if (!WriteBaseline(baseline_path, results))
+        {
+            fprintf(stderr, "cannot write baseline %s\n", baseline_path);
+            return 2;
+        }
+
+        printf("baseline written to %s\n", baseline_path);
+        return 0;
+    }
+
+    printf("threshold %.0f%%: %s\n", threshold, regression ? "FAIL" : "PASS");
+    return regression ? 1 : 0;
+}
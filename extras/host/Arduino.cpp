@@ -0,0 +1,55 @@
+/*
+ * Minimal Arduino API for building nDisplay on a host.
+ */
+
+#include "Arduino.h"
+
+static uint64_t s_time_us;
+
+
+uint32_t millis(void)
+{
+    return s_time_us / 1000;
+}
+
+
+uint32_t micros(void)
+{
+    return s_time_us;
+}
+
+
+void delay(uint32_t delay_ms)
+{
+    HostAdvance(delay_ms);
+}
+
+
+void HostSetTime(const uint32_t time_ms)
+{
+    s_time_us = static_cast<uint64_t>(time_ms) * 1000;
+}
+
+
+void HostAdvance(const uint32_t delay_ms)
+{
+    s_time_us += static_cast<uint64_t>(delay_ms) * 1000;
+}
+
+
+long random(long max)
+{
+    return random(0, max);
+}
+
+
+long random(long min, long max)
+{
+    return (max > min) ? (min + (rand() % (max - min))) : min;
+}
+
+
+void randomSeed(unsigned long seed)
+{
+    srand(seed);
+}
@@ -0,0 +1,52 @@
+/*
+ * Minimal Arduino API for building nDisplay on a host.
+ *
+ * Time is virtual: millis() and micros() return a clock that only moves
+ * when delay() is called or HostAdvance() is used, so effects and prompts
+ * run without sleeping and timing is deterministic.
+ */
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avr/pgmspace.h"
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+// Virtual clock
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t delay_ms);
+void HostSetTime(const uint32_t time_ms);
+void HostAdvance(const uint32_t delay_ms);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+class Print
+{
+    public:
+    virtual ~Print(void) {}
+    virtual size_t write(uint8_t byte) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t count = 0;
+
+        while (size--)
+        {
+            count += write(*buffer++);
+        }
+
+        return count;
+    }
+};
+
+#endif
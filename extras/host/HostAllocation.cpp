@@ -0,0 +1,54 @@
+/*
+ * Counting replacements for the global operator new and delete.
+ */
+
+#include "HostAllocation.h"
+
+#include <new>
+#include <stdlib.h>
+
+static uint64_t s_allocation_count;
+
+uint64_t HostAllocationCount(void)
+{
+    return s_allocation_count;
+}
+
+void* operator new(size_t size)
+{
+    s_allocation_count++;
+
+    if (void* ptr = malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+    (void)size;
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept
+{
+    (void)size;
+    free(ptr);
+}
@@ -0,0 +1,16 @@
+/*
+ * Heap allocation counter for host tests and the benchmark.
+ *
+ * Linking HostAllocation.cpp into an executable replaces the global
+ * operator new and delete with versions that count every allocation.
+ */
+
+#ifndef _HOST_ALLOCATION_H_
+#define _HOST_ALLOCATION_H_
+
+#include <stdint.h>
+
+// Number of operator new calls since start
+uint64_t HostAllocationCount(void);
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * CDisplayCounter: initial display, group limits and carries
+ */
+
+#include <nDisplay.h>
+#include <nDisplayCounter.h>
+
+#include "test.h"
+
+static bool IsShown(CDisplay& display, const char* expected)
+{
+    char s[8];
+
+    display.GetDisplayValue(s);
+    return (memcmp(s, expected, display.GetUnitCount()) == 0);
+}
+
+// Units show the initial value before any SetValue
+static void TestInitial(void)
+{
+    CDisplay display(6);
+    display.FillRangeValue(0, 6, '-');
+
+    CDisplayCounter counter(display, 0, 6);
+    CHECK(IsShown(display, "000000"));
+    counter.Increment();
+    CHECK(IsShown(display, "000001"));
+}
+
+// A group already above a new limit is clamped to it
+static void TestGroupClamp(void)
+{
+    CDisplay display(4);
+    CDisplayCounter counter(display, 0, 4);
+
+    counter.SetValue(59);
+    CHECK(counter.SetGroup(0, 2, 30) == CDisplay::STATUS_OK);
+    CHECK(counter.GetValue() == 30);
+    CHECK(IsShown(display, "0030"));
+    counter.Increment();
+    CHECK(counter.GetValue() == 31);
+    CHECK(IsShown(display, "0100"));
+}
+
+static void TestClock(void)
+{
+    CDisplay display(6);
+    CDisplayCounter counter(display, 0, 6);
+
+    counter.SetGroup(0, 2, 59);
+    counter.SetGroup(2, 2, 59);
+    counter.SetGroup(4, 2, 23);
+    counter.SetValue(86399); // 23:59:59
+    CHECK(IsShown(display, "235959"));
+    counter.Increment();
+    CHECK(IsShown(display, "000000"));
+    counter.Decrement();
+    CHECK(counter.GetValue() == 86399);
+}
+
+
+int main(void)
+{
+    TestInitial();
+    TestGroupClamp();
+    TestClock();
+    return TEST_RESULT();
+}
@@ -0,0 +1,218 @@
+/*
+ * Overlay layers: fades below overlays, selection across push and pop,
+ * buffer reuse, the prompt fallback when no overlay is available and tasks
+ * drawing beneath a prompt.
+ */
+
+#include <nDisplay.h>
+#include <nDisplayCounter.h>
+#include <nScheduler.h>
+#include <HostAllocation.h>
+
+#include "test.h"
+
+#define UNIT_COUNT  4
+
+// Selects on the first poll and releases on the next
+static bool s_input_select;
+
+struct SelectInput
+{
+    static bool IsIncrement(CDisplay& display) { (void)display; return false; }
+    static bool IsUpdate(CDisplay& display) { (void)display; return false; }
+
+    static bool IsSelect(CDisplay& display)
+    {
+        (void)display;
+        s_input_select = !s_input_select;
+        return s_input_select;
+    }
+};
+
+// Never selects; every poll takes 1 ms
+struct IdleInput
+{
+    static bool IsIncrement(CDisplay& display) { (void)display; return false; }
+    static bool IsSelect(CDisplay& display) { (void)display; return false; }
+    static bool IsUpdate(CDisplay& display) { (void)display; delay(1); return false; }
+};
+
+static CScheduler* s_scheduler;
+
+static uint32_t CounterTask(void* context)
+{
+    static_cast<CDisplayCounter*>(context)->Increment();
+    return 100;
+}
+
+// A fade started on the base layer keeps running while an overlay is pushed
+static void TestFadeBelowOverlay(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    display.FadeDisplayLevel(255, 100);
+    CHECK(display.UpdateFade(50));
+    CHECK(display.PushOverlay() == CDisplay::STATUS_OK);
+    display.SetOverlayMask(0, false);
+
+    uint8_t duty = display.GetUnitDuty(0);
+    CHECK(display.UpdateFade(10));
+    CHECK(display.GetUnitDuty(0) > duty); // Visible through transparent unit
+    CHECK(display.GetUnitLevel(1) == 127); // Overlay unaffected
+
+    CHECK(display.PopOverlay() == CDisplay::STATUS_OK);
+    CHECK(display.UpdateFade(20));
+    CHECK(!display.UpdateFade(20));
+
+    for (type_unit unit = 0; unit < UNIT_COUNT; unit++)
+    {
+        CHECK(display.GetUnitLevel(unit) == 255);
+    }
+}
+
+// A fade on an overlay ends with the overlay
+static void TestFadeOnOverlay(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    display.SetDisplayLevel(255);
+    display.PushOverlay();
+    display.FadeDisplayLevel(0, 100);
+    CHECK(display.UpdateFade(50));
+    display.PopOverlay();
+    CHECK(!display.UpdateFade(10));
+    CHECK(display.GetUnitLevel(0) == 255);
+}
+
+static void TestSelection(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    display.SetDisplayValue("0000");
+    display.PushOverlay();
+    CHECK(display.SelectLayer(0) == CDisplay::STATUS_OK);
+
+    // Selection below a popped overlay is kept
+    display.PushOverlay();
+    display.PopOverlay();
+    display.SetUnitValue(0, 'B');
+    display.PopOverlay();
+    CHECK(display.GetUnitValue(0) == 'B');
+
+    // Selection of the popped overlay falls back to the one before the push
+    display.PushOverlay();
+    display.SelectLayer(0);
+    display.PushOverlay();
+    display.PopOverlay();
+    display.SetUnitValue(1, 'B');
+    display.PopOverlay();
+    CHECK(display.GetUnitValue(1) == 'B');
+}
+
+static void TestBufferReuse(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    for (uint8_t count = 0; count < 2; count++)
+    {
+        display.PushOverlay();
+        display.PushOverlay();
+        display.PopOverlay();
+        display.PopOverlay();
+    }
+
+    uint64_t allocation_start = HostAllocationCount();
+
+    display.PushOverlay();
+    display.PushOverlay();
+    display.PopOverlay();
+    display.PopOverlay();
+    CHECK(HostAllocationCount() == allocation_start);
+}
+
+// With every overlay in use the prompt draws on the top layer and restores it
+static void TestPromptFallback(void)
+{
+    static const type_unit position[] = {0};
+    static const uint8_t digit_count[] = {2};
+    static const type_item lower_limit[] = {0};
+    static const type_item upper_limit[] = {99};
+    type_item value[] = {42};
+    char s[UNIT_COUNT];
+
+    CDisplay display(UNIT_COUNT);
+    CDisplay::PromptValueStruct prompt;
+
+    prompt.item_count = 1;
+    prompt.item_position = position;
+    prompt.item_digit_count = digit_count;
+    prompt.item_lower_limit = lower_limit;
+    prompt.item_upper_limit = upper_limit;
+    prompt.item_value = value;
+    prompt.initial_display = " ";
+
+    while (display.PushOverlay() == CDisplay::STATUS_OK)
+    {
+        // Fill layer stack
+    }
+
+    display.SetDisplayValue("ABCD");
+    display.SetDisplayLevel(100);
+    display.Flush();
+
+    CHECK(display.PromptValue<SelectInput>(prompt) == 0);
+    CHECK(display.GetOverlayCount() == 3);
+    CHECK(display.GetDisplayValue(s) == CDisplay::STATUS_OK);
+    CHECK(memcmp(s, "ABCD", UNIT_COUNT) == 0);
+    CHECK(display.GetUnitLevel(0) == 100);
+}
+
+
+// A task ticking a counter while a prompt is up draws on the base layer
+static void TestTaskBelowPrompt(void)
+{
+    static const char* const item[] = {"A", "B"};
+    char s[2 * UNIT_COUNT];
+
+    CDisplay display(2 * UNIT_COUNT);
+    CDisplayCounter counter(display, UNIT_COUNT, UNIT_COUNT);
+    CScheduler scheduler(1);
+    CDisplay::PromptSelectStruct prompt;
+
+    prompt.item_count = 2;
+    prompt.item_array = reinterpret_cast<const type_array*>(item);
+
+    s_scheduler = &scheduler;
+    scheduler.SetCallbackIdle([](uint32_t ms) { delay(ms); });
+    display.SetCallbackDelay([](uint32_t ms) { s_scheduler->Delay(ms); });
+    display.SetCallbackTime([]() { return s_scheduler->GetTime(); });
+    display.FillRangeValue(0, UNIT_COUNT, '-');
+    scheduler.AddTask(CounterTask, &counter, 100);
+
+    CHECK(display.PromptSelect<IdleInput>(prompt, 10) == -1);
+    CHECK(display.GetOverlayCount() == 0);
+    CHECK(counter.GetValue() > 0);
+
+    uint32_t value = counter.GetValue();
+
+    display.GetDisplayValue(s);
+    CHECK(memcmp(s, "----", UNIT_COUNT) == 0);
+
+    for (uint8_t digit = 0; digit < UNIT_COUNT; digit++)
+    {
+        CHECK(s[2 * UNIT_COUNT - 1 - digit] == static_cast<char>('0' + (value % 10)));
+        value /= 10;
+    }
+}
+
+
+int main(void)
+{
+    TestFadeBelowOverlay();
+    TestFadeOnOverlay();
+    TestSelection();
+    TestBufferReuse();
+    TestPromptFallback();
+    TestTaskBelowPrompt();
+    return TEST_RESULT();
+}
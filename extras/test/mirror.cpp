@@ -0,0 +1,316 @@
+/*
+ * CDisplayMirror to CMirrorDecoder round trip over a pipe
+ *
+ * Every frame of the built-in effects is encoded into one end of a pipe,
+ * decoded from the other and compared with the source display. Reports the
+ * bytes per frame for each effect, then checks that the decoder ignores
+ * deltas after a dropped or corrupted packet and resynchronizes on the next
+ * keyframe. A keyframe with a damaged unit count must leave the last frame
+ * intact.
+ */
+
+#include <nDisplay.h>
+#include <nDisplayMirror.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#define UNIT_COUNT          8
+#define KEYFRAME_INTERVAL   32
+
+// Writes the stream into a pipe, optionally losing or damaging one packet
+class PipeSink : public Print
+{
+    public:
+    enum class Fault : uint8_t
+    {
+        NONE,
+        DROP,
+        CORRUPT,
+    };
+
+    protected:
+    int m_fd;
+    Fault m_fault;
+    uint32_t m_byte_index;
+    uint32_t m_fault_index;
+
+    public:
+    PipeSink(const int fd) : m_fd{fd}, m_fault{Fault::NONE}, m_byte_index{0}, m_fault_index{0} {}
+
+    // Index 4 is the first byte after the packet header, 3 the keyframe unit count
+    void SetFault(const Fault fault, const uint32_t fault_index = 4)
+    {
+        m_fault = fault;
+        m_byte_index = 0;
+        m_fault_index = fault_index;
+    }
+
+    size_t write(uint8_t byte) override
+    {
+        if (m_fault == Fault::DROP)
+        {
+            return 1;
+        }
+
+        if ((m_fault == Fault::CORRUPT) && (m_byte_index++ == m_fault_index))
+        {
+            byte ^= 0x01;
+        }
+
+        return (::write(m_fd, &byte, 1) == 1) ? 1 : 0;
+    }
+};
+
+static int s_pipe[2];
+static CDisplay s_display(UNIT_COUNT);
+static PipeSink* s_sink;
+static CDisplayMirror* s_mirror;
+static CMirrorDecoder s_decoder;
+static uint32_t s_frame_count;
+static uint32_t s_mismatch_count;
+
+// Feed all pending bytes to the decoder. Returns number of completed frames.
+static uint32_t Receive(void)
+{
+    uint32_t frame_count = 0;
+    uint8_t buffer[256];
+    ssize_t length;
+
+    while ((length = read(s_pipe[0], buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t index = 0; index < length; index++)
+        {
+            frame_count += s_decoder.Decode(buffer[index]);
+        }
+    }
+
+    return frame_count;
+}
+
+static bool IsMatch(void)
+{
+    if (s_decoder.GetUnitCount() != s_display.GetUnitCount())
+    {
+        return false;
+    }
+
+    for (type_unit unit = 0; unit < s_display.GetUnitCount(); unit++)
+    {
+        if ((s_decoder.GetUnitValue(unit) != s_display.GetUnitValue(unit)) ||
+            (s_decoder.GetUnitIndicator(unit) != s_display.GetUnitIndicator(unit)) ||
+            (s_decoder.GetUnitLevel(unit) != s_display.GetUnitLevel(unit)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Called by the effects between frames
+static void MirrorDelay(uint32_t delay_ms)
+{
+    s_mirror->Update();
+    Receive();
+    s_mismatch_count += !IsMatch();
+    s_frame_count++;
+    delay(delay_ms);
+}
+
+template<typename Effect>
+static void RunEffect(const char* name, Effect effect)
+{
+    uint32_t byte_start = s_mirror->GetByteCount();
+    uint32_t frame_start = s_frame_count;
+    uint32_t mismatch_start = s_mismatch_count;
+
+    effect();
+
+    uint32_t frame_count = s_frame_count - frame_start;
+
+    printf("%-18s frames=%4u bytes/frame=%6.2f\n", name, frame_count,
+           frame_count ? static_cast<double>(s_mirror->GetByteCount() - byte_start) / frame_count : 0.0);
+    CHECK(frame_count > 0);
+    CHECK(s_mismatch_count == mismatch_start);
+}
+
+static void TestEffects(void)
+{
+    s_display.SetDisplayLevel(255);
+    s_display.SetDisplayValue("12:34:56");
+    s_mirror->Update(); // Initial keyframe
+    CHECK(Receive() == 1);
+    CHECK(IsMatch());
+
+    RunEffect("EffectScroll", []() { s_display.EffectScroll("HELLO WORLD ", CDisplay::Direction::LEFT, 0); });
+    RunEffect("EffectSlotMachine", []() { s_display.EffectSlotMachine(0); });
+    RunEffect("EffectStrobe", []() { s_display.EffectStrobe(10, 0); });
+    RunEffect("FadeDisplayLevel", []()
+    {
+        s_display.FadeDisplayLevel(0, 500);
+
+        while (s_display.UpdateFade(20))
+        {
+            MirrorDelay(20);
+        }
+    });
+}
+
+// Damage one delta, then check deltas are ignored until a keyframe
+static void TestResync(const PipeSink::Fault fault, const bool request_keyframe)
+{
+    char expected[UNIT_COUNT + 1];
+    char s[UNIT_COUNT + 1];
+
+    s_display.SetDisplayLevel(255);
+    s_display.SetDisplayValue("00000000");
+    s_mirror->RequestKeyframe();
+    s_mirror->Update();
+    Receive();
+    CHECK(IsMatch());
+
+    for (type_unit unit = 0; unit < UNIT_COUNT; unit++)
+    {
+        expected[unit] = s_decoder.GetUnitValue(unit);
+    }
+
+    s_display.SetUnitValue(0, '1');
+    s_sink->SetFault(fault);
+    s_mirror->Update();
+    s_sink->SetFault(PipeSink::Fault::NONE);
+    CHECK(Receive() == 0);
+
+    // Following deltas must not be applied to the stale frame
+    for (uint8_t index = 0; index < 4; index++)
+    {
+        s_display.SetUnitValue(1 + index, 'A' + index);
+        s_mirror->Update();
+        CHECK(Receive() == 0);
+        CHECK(!s_decoder.IsSynchronized());
+
+        for (type_unit unit = 0; unit < UNIT_COUNT; unit++)
+        {
+            s[unit] = s_decoder.GetUnitValue(unit);
+        }
+
+        CHECK(memcmp(s, expected, UNIT_COUNT) == 0);
+    }
+
+    if (request_keyframe)
+    {
+        s_mirror->RequestKeyframe();
+    }
+
+    // Keyframe is sent on request or at the latest after the interval
+    for (uint8_t index = 0; (index < KEYFRAME_INTERVAL) && !s_decoder.IsSynchronized(); index++)
+    {
+        s_display.SetUnitValue(UNIT_COUNT - 1, '0' + (index % 10));
+        s_mirror->Update();
+        Receive();
+    }
+
+    CHECK(s_decoder.IsSynchronized());
+    CHECK(IsMatch());
+
+    // Deltas apply again after resync
+    s_display.SetUnitValue(0, '9');
+    s_mirror->Update();
+    CHECK(Receive() == 1);
+    CHECK(IsMatch());
+}
+
+
+// A keyframe failing its checksum must not discard the committed frame
+static void TestKeyframeUnitCount(void)
+{
+    s_display.SetDisplayLevel(255);
+    s_display.SetDisplayValue("ABCDEFGH");
+    s_mirror->RequestKeyframe();
+    s_mirror->Update();
+    CHECK(Receive() == 1);
+    CHECK(IsMatch());
+
+    s_display.SetDisplayValue("12345678");
+    s_mirror->RequestKeyframe();
+    s_sink->SetFault(PipeSink::Fault::CORRUPT, 3);
+    s_mirror->Update();
+    s_sink->SetFault(PipeSink::Fault::NONE);
+    CHECK(Receive() == 0);
+    CHECK(!s_decoder.IsSynchronized());
+    CHECK(s_decoder.GetUnitCount() == UNIT_COUNT);
+    CHECK(s_decoder.GetUnitValue(0) == 'A');
+    CHECK(s_decoder.GetUnitValue(UNIT_COUNT - 1) == 'H');
+
+    s_mirror->RequestKeyframe();
+    s_mirror->Update();
+    CHECK(Receive() == 1);
+    CHECK(IsMatch());
+}
+
+
+// Changes in the last, partial block of a full-size frame are sent
+static void TestLastBlock(void)
+{
+    int pipe_last[2];
+
+    if (pipe(pipe_last) != 0)
+    {
+        CHECK(false);
+        return;
+    }
+
+    CDisplay display(255);
+    PipeSink sink(pipe_last[1]);
+    CDisplayMirror mirror(display, sink);
+    CMirrorDecoder decoder;
+    uint8_t buffer[1024];
+    ssize_t length;
+
+    CHECK(mirror.Update() > 0); // Keyframe
+    CHECK(mirror.Update() == 0); // Nothing changed
+    display.SetUnitValue(254, 'Z');
+    CHECK(mirror.Update() > 0);
+    close(pipe_last[1]);
+
+    while ((length = read(pipe_last[0], buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t index = 0; index < length; index++)
+        {
+            decoder.Decode(buffer[index]);
+        }
+    }
+
+    close(pipe_last[0]);
+    CHECK(decoder.GetUnitCount() == 255);
+    CHECK(decoder.GetUnitValue(254) == 'Z');
+}
+
+
+int main(void)
+{
+    if ((pipe(s_pipe) != 0) || (fcntl(s_pipe[0], F_SETFL, O_NONBLOCK) != 0))
+    {
+        perror("pipe");
+        return 2;
+    }
+
+    PipeSink sink(s_pipe[1]);
+    CDisplayMirror mirror(s_display, sink, KEYFRAME_INTERVAL);
+
+    s_sink = &sink;
+    s_mirror = &mirror;
+    s_display.SetCallbackDelay(MirrorDelay);
+
+    TestEffects();
+    TestResync(PipeSink::Fault::DROP, true);
+    TestResync(PipeSink::Fault::CORRUPT, true);
+    TestResync(PipeSink::Fault::DROP, false);
+    TestResync(PipeSink::Fault::CORRUPT, false);
+    TestKeyframeUnitCount();
+    TestLastBlock();
+
+    return TEST_RESULT();
+}
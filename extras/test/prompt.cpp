@@ -0,0 +1,110 @@
+/*
+ * PromptValue blink: fades between levels on the display clock and keeps
+ * fades started before the prompt running, also on the blinked unit.
+ */
+
+#include <nDisplay.h>
+
+#include "test.h"
+
+#define UNIT_COUNT  4
+
+// Every poll takes 1 ms and records the level of the prompted unit
+static bool s_level_seen[256];
+
+struct IdleInput
+{
+    static bool IsIncrement(CDisplay& display) { (void)display; return false; }
+    static bool IsSelect(CDisplay& display) { (void)display; return false; }
+
+    static bool IsUpdate(CDisplay& display)
+    {
+        delay(1);
+        s_level_seen[display.GetUnitLevel(0)] = true;
+        return false;
+    }
+};
+
+static void TestBlink(void)
+{
+    static const type_unit position[] = {0};
+    static const uint8_t digit_count[] = {2};
+    static const type_item lower_limit[] = {0};
+    static const type_item upper_limit[] = {99};
+    type_item value[] = {7};
+
+    CDisplay display(UNIT_COUNT);
+    CDisplay::PromptValueStruct prompt;
+
+    prompt.item_count = 1;
+    prompt.item_position = position;
+    prompt.item_digit_count = digit_count;
+    prompt.item_lower_limit = lower_limit;
+    prompt.item_upper_limit = upper_limit;
+    prompt.item_value = value;
+    prompt.initial_display = " ";
+
+    // Base layer fade outlasting the prompt setup
+    display.SetDisplayLevel(0);
+    display.FadeUnitLevel(3, 255, 2000);
+
+    uint32_t time_start = millis();
+    CHECK(display.PromptValue<IdleInput>(prompt, 1600) == -1);
+    uint32_t elapsed = millis() - time_start;
+
+    uint16_t level_count = 0;
+
+    for (uint16_t level = 0; level < 256; level++)
+    {
+        level_count += s_level_seen[level];
+    }
+
+    // Blink passes through intermediate levels, not just min and max
+    CHECK(level_count > 4);
+    CHECK(s_level_seen[31]); // Brightness::L1
+    CHECK(s_level_seen[255]);
+
+    // 62 blinks of 100 ms after the scroll in
+    CHECK(elapsed > 6200);
+    CHECK(elapsed < 6200 + 500);
+
+    CHECK(!display.UpdateFade(0)); // Base fade completed during the prompt
+    CHECK(display.GetUnitLevel(3) == 255);
+    printf("blink levels=%u timeout=%u ms\n", level_count, elapsed);
+}
+
+
+// The blink on the overlay does not take over a base fade of the same unit
+static void TestBlinkOverFade(void)
+{
+    static const type_unit position[] = {0};
+    static const uint8_t digit_count[] = {1};
+    static const type_item lower_limit[] = {0};
+    static const type_item upper_limit[] = {9};
+    type_item value[] = {7};
+
+    CDisplay display(UNIT_COUNT);
+    CDisplay::PromptValueStruct prompt;
+
+    prompt.item_count = 1;
+    prompt.item_position = position;
+    prompt.item_digit_count = digit_count;
+    prompt.item_lower_limit = lower_limit;
+    prompt.item_upper_limit = upper_limit;
+    prompt.item_value = value;
+    prompt.initial_display = " ";
+
+    display.SetDisplayLevel(0);
+    display.FadeUnitLevel(0, 255, 2000);
+    CHECK(display.PromptValue<IdleInput>(prompt, 1600) == -1);
+    CHECK(!display.UpdateFade(0));
+    CHECK(display.GetUnitLevel(0) == 255);
+}
+
+
+int main(void)
+{
+    TestBlink();
+    TestBlinkOverFade();
+    return TEST_RESULT();
+}
@@ -0,0 +1,54 @@
+/*
+ * Range primitives: shift and rotate, including a zero count
+ */
+
+#include <nDisplay.h>
+
+#include "test.h"
+
+#define UNIT_COUNT  8
+
+static bool IsShown(CDisplay& display, const char* expected)
+{
+    char s[UNIT_COUNT];
+
+    display.GetDisplayValue(s);
+    return (memcmp(s, expected, UNIT_COUNT) == 0);
+}
+
+static void TestRotate(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    display.SetDisplayValue("ABCDEFGH");
+    CHECK(display.RotateDisplayValue(CDisplay::Direction::LEFT, 0) == CDisplay::STATUS_OK);
+    CHECK(display.RotateRangeValue(2, 4, CDisplay::Direction::RIGHT, 0) == CDisplay::STATUS_OK);
+    CHECK(IsShown(display, "ABCDEFGH"));
+
+    CHECK(display.RotateDisplayValue(CDisplay::Direction::LEFT, 3) == CDisplay::STATUS_OK);
+    CHECK(IsShown(display, "DEFGHABC"));
+    CHECK(display.RotateRangeValue(0, 4, CDisplay::Direction::RIGHT) == CDisplay::STATUS_OK);
+    CHECK(IsShown(display, "GDEFHABC"));
+
+    // Range outside display is rejected, even with nothing to rotate
+    CHECK(display.RotateRangeValue(6, 4, CDisplay::Direction::LEFT, 0) == CDisplay::STATUS_ERROR);
+}
+
+static void TestShift(void)
+{
+    CDisplay display(UNIT_COUNT);
+
+    display.SetDisplayValue("ABCDEFGH");
+    CHECK(display.ShiftRangeValue(1, 6, CDisplay::Direction::LEFT, "xy", 2) == CDisplay::STATUS_OK);
+    CHECK(IsShown(display, "ADEFGxyH"));
+    CHECK(display.ShiftDisplayValue(CDisplay::Direction::RIGHT, nullptr, 1) == CDisplay::STATUS_OK);
+    CHECK(IsShown(display, " ADEFGxy"));
+}
+
+
+int main(void)
+{
+    TestRotate();
+    TestShift();
+    return TEST_RESULT();
+}
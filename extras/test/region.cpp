@@ -0,0 +1,123 @@
+/*
+ * CDisplayRegion: regions animating in the same tick stay within their
+ * units, a new effect does not take a running effect's frame as its target
+ * and a region outside the display reports errors.
+ */
+
+#include <nDisplay.h>
+#include <nDisplayRegion.h>
+
+#include "test.h"
+
+#define UNIT_COUNT  12
+
+// Units outside both regions
+static const type_unit s_outside[] = {0, 1, 5, 10, 11};
+
+// Units of display outside [unit, unit + unit_count) are unchanged since s
+static bool IsUntouched(CDisplay& display, const char* s, const type_unit unit, const type_unit unit_count)
+{
+    for (type_unit index = 0; index < UNIT_COUNT; index++)
+    {
+        if (((index < unit) || (index >= unit + unit_count)) && (display.GetUnitValue(index) != s[index]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void TestSameTick(void)
+{
+    CDisplay display(UNIT_COUNT);
+    CDisplayRegion left(display, 2, 3);
+    CDisplayRegion right(display, 6, 4);
+    char s[UNIT_COUNT];
+    uint16_t tick = 0;
+
+    display.SetDisplayValue("############");
+    CHECK(left.SetValue("ABC") == CDisplay::STATUS_OK);
+    CHECK(right.SetValue(1234) == CDisplay::STATUS_OK);
+
+    display.GetDisplayValue(s);
+    left.EffectScroll("HELLO WORLD", CDisplay::Direction::LEFT, 10);
+    CHECK(IsUntouched(display, s, 2, 3));
+
+    display.GetDisplayValue(s);
+    right.EffectSlotMachine(10);
+    CHECK(IsUntouched(display, s, 6, 4));
+
+    while ((left.GetEffect() != CDisplayRegion::Effect::NONE) ||
+           (right.GetEffect() != CDisplayRegion::Effect::NONE))
+    {
+        display.GetDisplayValue(s);
+        left.Update(10);
+        CHECK(IsUntouched(display, s, 2, 3));
+
+        display.GetDisplayValue(s);
+        right.Update(10);
+        CHECK(IsUntouched(display, s, 6, 4));
+
+        if (++tick == 20)
+        {
+            display.GetDisplayValue(s);
+            left.EffectStrobe(4, 10);
+            CHECK(IsUntouched(display, s, 2, 3));
+        }
+    }
+
+    for (uint8_t index = 0; index < sizeof(s_outside) / sizeof(s_outside[0]); index++)
+    {
+        CHECK(display.GetUnitValue(s_outside[index]) == '#');
+    }
+
+    CHECK(right.GetValue(s) == CDisplay::STATUS_OK);
+    CHECK(memcmp(s, "1234", 4) == 0);
+}
+
+// Restarting an effect keeps the value the running one was heading for
+static void TestRestart(void)
+{
+    CDisplay display(4);
+    CDisplayRegion region(display, 0, 4);
+    char s[4];
+
+    region.SetValue("WXYZ");
+    region.EffectSlotMachine(10);
+    region.Update(50);
+    region.EffectStrobe(2, 10);
+    region.Update(10);
+    region.EffectSlotMachine(10);
+
+    while (region.Update(10))
+    {
+        // Run to completion
+    }
+
+    CHECK(region.GetValue(s) == CDisplay::STATUS_OK);
+    CHECK(memcmp(s, "WXYZ", 4) == 0);
+}
+
+static void TestInvalid(void)
+{
+    CDisplay display(4);
+    CDisplayRegion region(display, 2, 4);
+    char s[4];
+
+    CHECK(region.GetUnitCount() == 0);
+    CHECK(region.SetValue("AB") == CDisplay::STATUS_ERROR);
+    CHECK(region.SetValue(12) == CDisplay::STATUS_ERROR);
+    CHECK(region.GetValue(s) == CDisplay::STATUS_ERROR);
+    region.EffectStrobe();
+    CHECK(region.GetEffect() == CDisplayRegion::Effect::NONE);
+}
+
+
+int main(void)
+{
+    TestSameTick();
+    TestRestart();
+    TestInvalid();
+    return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+/*
+ * CScheduler on a virtual clock: task order, reported stats, and prompt
+ * timeouts that follow the clock rather than the number of polls.
+ */
+
+#include <nDisplay.h>
+#include <nScheduler.h>
+
+#include "test.h"
+
+static uint32_t s_time;
+static CScheduler s_scheduler(4);
+
+static uint32_t VirtualTime(void)
+{
+    return s_time;
+}
+
+// Jump to the next deadline instead of waiting
+static void VirtualIdle(uint32_t delay_ms)
+{
+    s_time += delay_ms;
+}
+
+static uint32_t FastTask(void* context)
+{
+    (void)context;
+    return 10;
+}
+
+// Takes 4 ms of clock time per run, delaying tasks due meanwhile
+static uint32_t SlowTask(void* context)
+{
+    (void)context;
+    s_time += 4;
+    return 25;
+}
+
+static void SchedulerDelay(uint32_t delay_ms)
+{
+    s_scheduler.Delay(delay_ms);
+}
+
+static uint32_t SchedulerTime(void)
+{
+    return s_scheduler.GetTime();
+}
+
+// Every poll takes 1 ms, so the prompt's wait loop advances the clock
+static uint32_t s_poll_count;
+
+struct IdleInput
+{
+    static bool IsIncrement(CDisplay& display) { (void)display; return false; }
+    static bool IsSelect(CDisplay& display) { (void)display; return false; }
+
+    static bool IsUpdate(CDisplay& display)
+    {
+        (void)display;
+        s_time++;
+        s_poll_count++;
+        return false;
+    }
+};
+
+static void TestStats(void)
+{
+    s_time = 0;
+
+    uint8_t fast = s_scheduler.AddTask(FastTask);
+    uint8_t slow = s_scheduler.AddTask(SlowTask);
+
+    CHECK(fast != CScheduler::TASK_INVALID);
+    CHECK(slow != CScheduler::TASK_INVALID);
+    s_scheduler.Delay(100);
+
+    CScheduler::TaskStats fast_stats = s_scheduler.GetTaskStats(fast);
+    CScheduler::TaskStats slow_stats = s_scheduler.GetTaskStats(slow);
+
+    // Fast task runs at 0, 10, ... 100; at 50 and 100 the slow task runs
+    // first and holds it up for 4 ms
+    CHECK(fast_stats.run_count == 11);
+    CHECK(fast_stats.latency_min == 0);
+    CHECK(fast_stats.latency_max == 4);
+    CHECK(fast_stats.latency_sum == 8);
+
+    // Slow task runs at 0, 25, 50, 75 and 100, always on time
+    CHECK(slow_stats.run_count == 5);
+    CHECK(slow_stats.latency_max == 0);
+    CHECK(s_time == 104);
+
+    s_scheduler.ResetTaskStats(fast);
+    CHECK(s_scheduler.GetTaskStats(fast).run_count == 0);
+    CHECK(s_scheduler.RemoveTask(fast));
+    CHECK(s_scheduler.RemoveTask(slow));
+    CHECK(!s_scheduler.RemoveTask(slow));
+}
+
+// Run a prompt until it times out, returns elapsed clock time
+static uint32_t PromptTimeout(CDisplay& display, const bool load)
+{
+    static const char* const item[] = {"A", "B"};
+    CDisplay::PromptSelectStruct prompt;
+    uint8_t task = CScheduler::TASK_INVALID;
+
+    prompt.item_count = 2;
+    prompt.item_array = reinterpret_cast<const type_array*>(item);
+    s_poll_count = 0;
+
+    if (load)
+    {
+        task = s_scheduler.AddTask(SlowTask);
+    }
+
+    uint32_t time_start = s_time;
+    CHECK(display.PromptSelect<IdleInput>(prompt, 100) == -1);
+    uint32_t elapsed = s_time - time_start;
+
+    s_scheduler.RemoveTask(task);
+    return elapsed;
+}
+
+static void TestPromptTimeout(void)
+{
+    CDisplay display(4);
+
+    display.SetCallbackDelay(SchedulerDelay);
+    display.SetCallbackTime(SchedulerTime);
+
+    uint32_t idle = PromptTimeout(display, false);
+    uint32_t idle_poll_count = s_poll_count;
+    uint32_t busy = PromptTimeout(display, true);
+
+    // Same clock time to timeout, although the loaded run polls less often
+    CHECK(s_poll_count < idle_poll_count);
+    CHECK(busy >= idle);
+    CHECK(busy <= idle + 4);
+    printf("prompt timeout idle=%u ms (%u polls) busy=%u ms (%u polls)\n", idle, idle_poll_count, busy, s_poll_count);
+}
+
+
+int main(void)
+{
+    s_scheduler.SetClock(VirtualTime);
+    s_scheduler.SetCallbackIdle(VirtualIdle);
+
+    TestStats();
+    TestPromptTimeout();
+    return TEST_RESULT();
+}
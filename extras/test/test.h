@@ -0,0 +1,24 @@
+/*
+ * Minimal check macro for the host tests
+ */
+
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+
+#include <stdio.h>
+
+static uint32_t s_failure_count;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            s_failure_count++; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (printf("%s\n", s_failure_count ? "FAIL" : "PASS"), (s_failure_count ? 1 : 0))
+
+#endif
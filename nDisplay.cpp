@@ -33,6 +33,29 @@
 #include <FastLED.h>
 #endif
 
+// Gamma corrected (2.2) duty cycle for each perceptual brightness level.
+// Levels 1-24 would round to duty 0 and are raised to 1, so any non-zero
+// level keeps the unit lit. Only level 0 turns it off.
+static const uint8_t s_gamma[256] PROGMEM =
+{
+      0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
 //---------------------------------------------------------------------
 // Implicit Function Prototypes
 //---------------------------------------------------------------------
@@ -40,12 +63,23 @@
 // strlen()
 // strncpy()
 // strncpy_P()
-
-
-CDisplay::CDisplay(const uint8_t unit_count)
-    : m_callback_is_increment{nullptr}
+// memcpy()
+// memset()
+
+
+CDisplay::CDisplay(const type_unit unit_count)
+    : m_draw{nullptr}
+    , m_layer_count{0}
+    , m_select{0}
+    , m_prompt{false}
+    , m_fade{nullptr}
+    , m_fade_count{0}
+    , m_fade_capacity{0}
+    , m_callback_is_increment{nullptr}
     , m_callback_is_select{nullptr}
     , m_callback_is_update{nullptr}
+    , m_callback_delay{nullptr}
+    , m_callback_time{nullptr}
 {
     Initialize(unit_count);
 }
@@ -53,11 +87,18 @@ CDisplay::CDisplay(const uint8_t unit_count)
 
 CDisplay::~CDisplay(void)
 {
+    for (uint8_t layer = 0; layer <= LAYER_MAX; layer++)
+    {
+        delete[] m_layer[layer].unit;
+        delete[] m_layer[layer].mask;
+    }
+
     delete[] m_display.unit;
+    delete[] m_fade;
 }
 
 
-void CDisplay::Initialize(const uint8_t unit_count)
+void CDisplay::Initialize(const type_unit unit_count)
 {
     // Allocate memory
     m_display.unit = new Unit[unit_count](); // Initialize to 0
@@ -66,21 +107,23 @@ void CDisplay::Initialize(const uint8_t unit_count)
     {
         m_display.unit_count = unit_count;
     }
+
+    m_draw = m_display.unit;
 }
 
 
-uint8_t CDisplay::GetUnitCount(void)
+type_unit CDisplay::GetUnitCount(void)
 {
     return m_display.unit_count;
 }
 
 
-CDisplay::status_t CDisplay::SetUnitValue(const uint8_t unit, const char character)
+CDisplay::status_t CDisplay::SetUnitValue(const type_unit unit, const char character)
 {
     if (unit < m_display.unit_count)
     {
-        uint8_t indicator = (m_display.unit[unit].value & 0x80);
-        m_display.unit[unit].value = (character & 0x7F) | indicator; // Preserve indicator
+        uint8_t indicator = (m_draw[unit].value & 0x80);
+        m_draw[unit].value = (character & 0x7F) | indicator; // Preserve indicator
         return STATUS_OK;
     }
 
@@ -88,17 +131,17 @@ CDisplay::status_t CDisplay::SetUnitValue(const uint8_t unit, const char charact
 }
 
 
-CDisplay::status_t CDisplay::SetUnitIndicator(const uint8_t unit, const bool state)
+CDisplay::status_t CDisplay::SetUnitIndicator(const type_unit unit, const bool state)
 {
     if (unit < m_display.unit_count)
     {
         if (state == true)
         {
-            m_display.unit[unit].value |= 0x80;
+            m_draw[unit].value |= 0x80;
         }
         else
         {
-            m_display.unit[unit].value &= ~0x80;            
+            m_draw[unit].value &= ~0x80;            
         }
 
         return STATUS_OK;
@@ -108,13 +151,14 @@ CDisplay::status_t CDisplay::SetUnitIndicator(const uint8_t unit, const bool sta
 }
 
 
-CDisplay::status_t CDisplay::SetUnitBrightness(const uint8_t unit, const Brightness brightness)
+CDisplay::status_t CDisplay::SetUnitBrightness(const type_unit unit, const Brightness brightness)
 {
     if (unit < m_display.unit_count)
     {
         if (brightness <= Brightness::MAX)
         {
-            m_display.unit[unit].brightness = brightness;
+            m_draw[unit].brightness = brightness;
+            m_draw[unit].level = LevelFromBrightness(brightness);
             return STATUS_OK;
         }
     }
@@ -125,17 +169,7 @@ CDisplay::status_t CDisplay::SetUnitBrightness(const uint8_t unit, const Brightn
 
 CDisplay::status_t CDisplay::SetDisplayValue(const char* string)
 {
-    if (string != nullptr)
-    {
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
-        {
-            SetUnitValue(index, string[index]);
-        }
-
-        return STATUS_OK;
-    }
-
-    return STATUS_ERROR;
+    return SetRangeValue(0, string, m_display.unit_count);
 }
 
 
@@ -160,7 +194,7 @@ CDisplay::status_t CDisplay::SetDisplayValue(const uint32_t value)
 
 CDisplay::status_t CDisplay::SetDisplayIndicator(const bool state)
 {
-    for (uint8_t index = 0; index < m_display.unit_count; index++)
+    for (type_unit index = 0; index < m_display.unit_count; index++)
     {
         SetUnitIndicator(index, state);
     }
@@ -173,9 +207,12 @@ CDisplay::status_t CDisplay::SetDisplayBrightness(const Brightness brightness)
 {
     if (brightness <= Brightness::MAX)
     {
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
+        uint8_t level = LevelFromBrightness(brightness);
+
+        for (type_unit index = 0; index < m_display.unit_count; index++)
         {
-            m_display.unit[index].brightness = brightness;
+            m_draw[index].brightness = brightness;
+            m_draw[index].level = level;
         }
 
         return STATUS_OK;
@@ -185,46 +222,215 @@ CDisplay::status_t CDisplay::SetDisplayBrightness(const Brightness brightness)
 }
 
 
-char CDisplay::GetUnitValue(const uint8_t unit)
+CDisplay::status_t CDisplay::SetUnitLevel(const type_unit unit, const uint8_t level)
+{
+    if (unit < m_display.unit_count)
+    {
+        m_draw[unit].level = level;
+        m_draw[unit].brightness = BrightnessFromLevel(level);
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::SetDisplayLevel(const uint8_t level)
+{
+    Brightness brightness = BrightnessFromLevel(level);
+
+    for (type_unit index = 0; index < m_display.unit_count; index++)
+    {
+        m_draw[index].level = level;
+        m_draw[index].brightness = brightness;
+    }
+
+    return STATUS_OK;
+}
+
+
+CDisplay::status_t CDisplay::SetRangeValue(const type_unit unit, const char* string, const type_unit length)
+{
+    if ((string != nullptr) && (static_cast<uint32_t>(unit) + length <= m_display.unit_count))
+    {
+        Unit* ptr = &m_draw[unit];
+
+        for (type_unit index = 0; index < length; index++)
+        {
+            ptr[index].value = (string[index] & 0x7F) | (ptr[index].value & 0x80); // Preserve indicator
+        }
+
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::FillRangeValue(const type_unit unit, const type_unit length, const char character)
+{
+    if (static_cast<uint32_t>(unit) + length <= m_display.unit_count)
+    {
+        Unit* ptr = &m_draw[unit];
+
+        for (type_unit index = 0; index < length; index++)
+        {
+            ptr[index].value = (character & 0x7F) | (ptr[index].value & 0x80); // Preserve indicator
+        }
+
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+// Shift range by count units and insert count characters from string into
+// the vacated units (spaces if string is nullptr). Indicators stay in place.
+CDisplay::status_t CDisplay::ShiftRangeValue(const type_unit unit, const type_unit length, const Direction direction, const char* string, const type_unit count)
+{
+    if ((count <= length) && (static_cast<uint32_t>(unit) + length <= m_display.unit_count))
+    {
+        Unit* ptr = &m_draw[unit];
+        type_unit remain = length - count;
+
+        if (direction == Direction::LEFT)
+        {
+            for (type_unit index = 0; index < remain; index++)
+            {
+                ptr[index].value = (ptr[index + count].value & 0x7F) | (ptr[index].value & 0x80);
+            }
+
+            ptr += remain; // Vacated units at end of range
+        }
+        else
+        {
+            for (type_unit index = length; index > count; index--)
+            {
+                ptr[index - 1].value = (ptr[index - count - 1].value & 0x7F) | (ptr[index - 1].value & 0x80);
+            }
+        }
+
+        for (type_unit index = 0; index < count; index++)
+        {
+            char character = (string != nullptr) ? string[index] : ' ';
+            ptr[index].value = (character & 0x7F) | (ptr[index].value & 0x80);
+        }
+
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::RotateRangeValue(const type_unit unit, const type_unit length, const Direction direction, const type_unit count)
+{
+    if ((count <= length) && (static_cast<uint32_t>(unit) + length <= m_display.unit_count))
+    {
+        if (count == 0)
+        {
+            return STATUS_OK; // Nothing to rotate, avoid zero-length buffer
+        }
+
+        char s[count];
+        const Unit* ptr = &m_draw[unit + ((direction == Direction::LEFT) ? 0 : length - count)];
+
+        for (type_unit index = 0; index < count; index++)
+        {
+            s[index] = ptr[index].value; // Units shifted out are inserted back
+        }
+
+        return ShiftRangeValue(unit, length, direction, s, count);
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::ShiftDisplayValue(const Direction direction, const char* string, const type_unit count)
+{
+    return ShiftRangeValue(0, m_display.unit_count, direction, string, count);
+}
+
+
+CDisplay::status_t CDisplay::RotateDisplayValue(const Direction direction, const type_unit count)
+{
+    return RotateRangeValue(0, m_display.unit_count, direction, count);
+}
+
+
+char CDisplay::GetUnitValue(const type_unit unit)
 {
     if (unit < m_display.unit_count)
     {
-        return m_display.unit[unit].value & 0x7F; // Mask indicator
+        return m_draw[unit].value & 0x7F; // Mask indicator
     }
 
     return 0;
 }
 
 
-bool CDisplay::GetUnitIndicator(const uint8_t unit)
+bool CDisplay::GetUnitIndicator(const type_unit unit)
 {
     if (unit < m_display.unit_count)
     {
-        return m_display.unit[unit].value & 0x80;
+        return m_draw[unit].value & 0x80;
     }
 
     return false;
 }
 
 
-CDisplay::Brightness CDisplay::GetUnitBrightness(const uint8_t unit)
+CDisplay::Brightness CDisplay::GetUnitBrightness(const type_unit unit)
 {
     if (unit < m_display.unit_count)
     {
-        return m_display.unit[unit].brightness;
+        return m_draw[unit].brightness;
     }
 
     return Brightness::MIN;
 }
 
 
+uint8_t CDisplay::GetUnitLevel(const type_unit unit)
+{
+    if (unit < m_display.unit_count)
+    {
+        return m_draw[unit].level;
+    }
+
+    return 0;
+}
+
+
+// Gamma corrected duty cycle of the displayed unit, at least 1 if level > 0
+uint8_t CDisplay::GetUnitDuty(const type_unit unit)
+{
+    if (unit < m_display.unit_count)
+    {
+        return pgm_read_byte(&s_gamma[m_display.unit[unit].level]);
+    }
+
+    return 0;
+}
+
+
 CDisplay::status_t CDisplay::GetDisplayValue(char* string)
 {
-    if (string != nullptr)
+    return GetRangeValue(0, string, m_display.unit_count);
+}
+
+
+CDisplay::status_t CDisplay::GetRangeValue(const type_unit unit, char* string, const type_unit length)
+{
+    if ((string != nullptr) && (static_cast<uint32_t>(unit) + length <= m_display.unit_count))
     {
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
+        const Unit* ptr = &m_draw[unit];
+
+        for (type_unit index = 0; index < length; index++)
         {
-            string[index] = m_display.unit[index].value & 0x7F; // Mask indicator
+            string[index] = ptr[index].value & 0x7F; // Mask indicator
         }
         
         return STATUS_OK;
@@ -234,34 +440,316 @@ CDisplay::status_t CDisplay::GetDisplayValue(char* string)
 }
 
 
-void CDisplay::EffectScroll(const char* string, const Direction direction, const uint32_t delay_ms)
+// Push an overlay layer initialized with the visible frame and fully opaque.
+// Set and get methods operate on the overlay until it is popped, leaving the
+// layers below intact. The composited frame is updated on Flush(). Layer
+// buffers are allocated on first use and kept, so later pushes never allocate.
+CDisplay::status_t CDisplay::PushOverlay(void)
 {
-    uint8_t string_length = strlen(string);
-    char s[m_display.unit_count + string_length];
+    type_unit mask_size = (static_cast<uint32_t>(m_display.unit_count) + 7) / 8;
+
+    if (m_layer_count >= LAYER_MAX)
+    {
+        return STATUS_ERROR;
+    }
+
+    Layer& layer = m_layer[m_layer_count + 1];
+
+    if (m_layer[0].unit == nullptr)
+    {
+        m_layer[0].unit = new Unit[m_display.unit_count];
+    }
+
+    if (layer.unit == nullptr)
+    {
+        layer.unit = new Unit[m_display.unit_count];
+    }
+
+    if (layer.mask == nullptr)
+    {
+        layer.mask = new uint8_t[mask_size];
+    }
 
-    if (direction == Direction::LEFT)
+    if ((m_layer[0].unit == nullptr) || (layer.unit == nullptr) || (layer.mask == nullptr))
     {
-        GetDisplayValue(s);
-        strncpy(s + m_display.unit_count, string, string_length);
+        return STATUS_ERROR; // Buffers allocated so far are kept for next push
+    }
+
+    Flush();
+
+    if (m_layer_count == 0)
+    {
+        // Move base layer out of composited frame
+        memcpy(m_layer[0].unit, m_display.unit, m_display.unit_count * sizeof(Unit));
+    }
+
+    memcpy(layer.unit, m_display.unit, m_display.unit_count * sizeof(Unit));
+    memset(layer.mask, 0xFF, mask_size);
+    layer.select = m_select;
+    m_layer_count++;
+    m_select = m_layer_count;
+    m_draw = layer.unit;
+    return STATUS_OK;
+}
+
+
+// Discard the top overlay and restore the frame beneath it. A layer selected
+// below the overlay stays selected, otherwise the selection before the push
+// is restored. Fades running on the overlay are dropped.
+CDisplay::status_t CDisplay::PopOverlay(void)
+{
+    uint16_t index = 0;
+
+    if (m_layer_count == 0)
+    {
+        return STATUS_ERROR;
+    }
+
+    while (index < m_fade_count)
+    {
+        if (m_fade[index].layer == m_layer_count)
+        {
+            m_fade[index] = m_fade[--m_fade_count];
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    if (m_select >= m_layer_count)
+    {
+        m_select = m_layer[m_layer_count].select;
+    }
+
+    m_layer_count--;
+
+    if (m_layer_count == 0)
+    {
+        // Base layer becomes composited frame again
+        memcpy(m_display.unit, m_layer[0].unit, m_display.unit_count * sizeof(Unit));
     }
     else
     {
-        strncpy(s, string, sizeof(s));
-        GetDisplayValue(s + string_length);
+        Flush();
+    }
+
+    m_draw = GetLayerUnit(m_select);
+    return STATUS_OK;
+}
+
+
+// Direct set and get methods to a layer, 0 being the base layer
+CDisplay::status_t CDisplay::SelectLayer(const uint8_t layer)
+{
+    if (layer <= m_layer_count)
+    {
+        m_select = layer;
+        m_draw = GetLayerUnit(layer);
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::SetOverlayMask(const type_unit unit, const bool opaque)
+{
+    if ((m_layer_count > 0) && (unit < m_display.unit_count))
+    {
+        uint8_t* mask = m_layer[m_layer_count].mask;
+
+        if (opaque == true)
+        {
+            mask[unit >> 3] |= (1 << (unit & 7));
+        }
+        else
+        {
+            mask[unit >> 3] &= ~(1 << (unit & 7));
+        }
+
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+// Composite layers into the displayed frame, topmost opaque unit wins
+void CDisplay::Flush(void)
+{
+    if (m_layer_count == 0)
+    {
+        return; // Layers are drawn directly
+    }
+
+    // Each mask byte covering a fully opaque or fully transparent block of
+    // 8 units is copied in bulk
+    for (uint32_t block = 0; block < m_display.unit_count; block += 8)
+    {
+        type_unit block_end = (m_display.unit_count - block < 8) ? m_display.unit_count : (block + 8);
+        type_unit mask_index = block >> 3;
+        uint8_t layer = m_layer_count;
+
+        while ((layer > 0) && (m_layer[layer].mask[mask_index] == 0))
+        {
+            layer--;
+        }
+
+        if ((layer == 0) || (m_layer[layer].mask[mask_index] == 0xFF))
+        {
+            memcpy(&m_display.unit[block], &m_layer[layer].unit[block], (block_end - block) * sizeof(Unit));
+            continue;
+        }
+
+        for (type_unit index = block; index < block_end; index++)
+        {
+            uint8_t unit_layer = layer;
+
+            while ((unit_layer > 0) && !(m_layer[unit_layer].mask[mask_index] & (1 << (index & 7))))
+            {
+                unit_layer--;
+            }
+
+            m_display.unit[index] = m_layer[unit_layer].unit[index];
+        }
+    }
+}
+
+
+CDisplay::status_t CDisplay::FadeUnitLevel(const type_unit unit, const uint8_t level, const uint16_t duration_ms)
+{
+    if (unit < m_display.unit_count)
+    {
+        uint16_t index = 0;
+
+        // Replace existing fade for unit on the selected layer only, so a fade
+        // beneath an overlay is not moved onto it
+        while ((index < m_fade_count) &&
+               ((m_fade[index].unit != unit) || (m_fade[index].layer != m_select)))
+        {
+            index++;
+        }
+
+        if (index == m_fade_count)
+        {
+            if (m_fade_count == m_fade_capacity)
+            {
+                // Grow fade list by one layer worth of units
+                if (m_fade_capacity > 0xFFFF - m_display.unit_count)
+                {
+                    return STATUS_ERROR;
+                }
+
+                Fade* fade = new Fade[m_fade_capacity + m_display.unit_count];
+
+                if (fade == nullptr)
+                {
+                    return STATUS_ERROR;
+                }
+
+                if (m_fade != nullptr)
+                {
+                    memcpy(fade, m_fade, m_fade_count * sizeof(Fade));
+                    delete[] m_fade;
+                }
+
+                m_fade = fade;
+                m_fade_capacity += m_display.unit_count;
+            }
+
+            m_fade_count++;
+        }
+
+        m_fade[index].unit = unit;
+        m_fade[index].layer = m_select;
+        m_fade[index].level = m_draw[unit].level;
+        m_fade[index].level_start = m_draw[unit].level;
+        m_fade[index].level_target = level;
+        m_fade[index].elapsed = 0;
+        m_fade[index].duration = duration_ms;
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+
+CDisplay::status_t CDisplay::FadeDisplayLevel(const uint8_t level, const uint16_t duration_ms)
+{
+    for (type_unit index = 0; index < m_display.unit_count; index++)
+    {
+        if (FadeUnitLevel(index, level, duration_ms) == STATUS_ERROR)
+        {
+            return STATUS_ERROR;
+        }
+    }
+
+    return STATUS_OK;
+}
+
+
+// Advance fades by elapsed time. Only units in transition are touched.
+// Each fade writes to the layer selected when it started and the frame is
+// flushed while overlays are present. A fade is dropped when it completes
+// or its unit was written directly. Returns true while any fade remains active.
+bool CDisplay::UpdateFade(const uint16_t elapsed_ms)
+{
+    uint16_t index = 0;
+
+    while (index < m_fade_count)
+    {
+        Fade& fade = m_fade[index];
+        Unit& unit = GetLayerUnit(fade.layer)[fade.unit];
+
+        if (unit.level == fade.level)
+        {
+            fade.elapsed = (elapsed_ms < fade.duration - fade.elapsed) ? (fade.elapsed + elapsed_ms) : fade.duration;
+
+            if (fade.elapsed < fade.duration)
+            {
+                int16_t delta = fade.level_target - fade.level_start;
+                fade.level = fade.level_start + static_cast<int32_t>(delta) * fade.elapsed / fade.duration;
+            }
+            else
+            {
+                fade.level = fade.level_target;
+            }
+
+            unit.level = fade.level;
+            unit.brightness = BrightnessFromLevel(fade.level);
+
+            if (fade.elapsed < fade.duration)
+            {
+                index++;
+                continue;
+            }
+        }
+
+        m_fade[index] = m_fade[--m_fade_count]; // Remove completed fade
     }
 
-    for (uint8_t index = 0; index < string_length; index++)
+    Flush();
+    return (m_fade_count > 0);
+}
+
+
+void CDisplay::EffectScroll(const char* string, const Direction direction, const uint32_t delay_ms)
+{
+    type_unit string_length = strlen(string);
+
+    for (type_unit index = 0; index < string_length; index++)
     {
         if (direction == Direction::LEFT)
         {
-            SetDisplayValue(1 + s + index);
+            ShiftDisplayValue(direction, string + index);
         }
         else
         {
-            SetDisplayValue(s + string_length - index - 1);
+            ShiftDisplayValue(direction, string + string_length - index - 1);
         }
 
-        delay(delay_ms);
+        Delay(delay_ms);
     }
 }
 
@@ -292,26 +780,33 @@ void CDisplay::EffectSlotMachine(const uint32_t delay_ms)
 
     GetDisplayValue(s);
 
-    for (uint8_t index = 0; index < m_display.unit_count; index++)
+    for (type_unit index = 0; index < m_display.unit_count; index++)
     {
         array[index] = 0;
     }
 
-    for (uint8_t count = 0; count < m_display.unit_count + 3; count++)
+    for (uint32_t count = 0; count < m_display.unit_count + 3UL; count++)
     {
         // Iterate at least 3 times before latching values
         if (count > 2)
         {
+            type_unit index;
+
             // Randomly select next unit to latch
-            while (array[random_fast(0, m_display.unit_count)]++);
+            do
+            {
+                index = random_fast(0, m_display.unit_count);
+            } while (array[index]);
+
+            array[index] = 1;
         }
 
         // Display random values for 5 cycles
         for (uint8_t repeat = 0; repeat < 5; repeat++)
         {
-            for (uint8_t index = 0; index < m_display.unit_count; index++)
+            for (type_unit index = 0; index < m_display.unit_count; index++)
             {
-                if (array[index] || ((index == 1) && (s[index] == ':')))
+                if (array[index] || (s[index] == ':'))
                 {
                     SetUnitValue(index, s[index]);
                 }
@@ -321,7 +816,7 @@ void CDisplay::EffectSlotMachine(const uint32_t delay_ms)
                 }
             }
 
-            delay(delay_ms);
+            Delay(delay_ms);
         }
     }
 }
@@ -341,13 +836,10 @@ void CDisplay::EffectStrobe(const uint8_t iteration, const uint32_t delay_ms)
         }
         else
         {
-            for (uint8_t index = 0; index < m_display.unit_count; index++)
-            {
-                SetUnitValue(index, ' ');
-            }
+            FillRangeValue(0, m_display.unit_count, ' ');
         }
 
-        delay(delay_ms);
+        Delay(delay_ms);
     }
 
     SetDisplayValue(s);
@@ -356,7 +848,7 @@ void CDisplay::EffectStrobe(const uint8_t iteration, const uint32_t delay_ms)
 
 void CDisplay::itoa(char* s, uint32_t value)
 {
-    uint8_t index = 0;
+    type_unit index = 0;
 
     while (index < m_display.unit_count)
     {
@@ -400,9 +892,105 @@ bool CDisplay::IsInputUpdate(void)
 }
 
 
-uint8_t CDisplay::random_fast(const uint8_t min, const uint8_t max)
+// Flush and wait between frames. A registered delay callback may use the time to
+// service other work, such as mirroring the frame or running other tasks.
+void CDisplay::Delay(const uint32_t delay_ms)
 {
-#ifdef USE_FASTLED
+    Flush();
+
+    if (m_callback_delay != nullptr)
+    {
+        CallbackDelay(delay_ms);
+    }
+    else
+    {
+        delay(delay_ms);
+    }
+}
+
+
+// Give a registered delay callback the chance to run other work while a
+// prompt waits for input
+void CDisplay::Yield(void)
+{
+    if (m_callback_delay != nullptr)
+    {
+        CallbackDelay(0);
+    }
+}
+
+
+uint32_t CDisplay::GetTime(void)
+{
+    return (m_callback_time != nullptr) ? m_callback_time() : millis();
+}
+
+
+// Without an overlay the prompt draws on the current layer, so save it
+void CDisplay::BeginPrompt(const bool overlay, Unit* frame)
+{
+    m_prompt = overlay;
+
+    if (overlay == false)
+    {
+        memcpy(frame, m_draw, m_display.unit_count * sizeof(Unit));
+    }
+}
+
+
+void CDisplay::EndPrompt(const bool overlay, const Unit* frame)
+{
+    if (overlay == true)
+    {
+        m_prompt = false;
+        PopOverlay();
+    }
+    else
+    {
+        memcpy(m_draw, frame, m_display.unit_count * sizeof(Unit));
+        Flush();
+    }
+}
+
+
+// Run the delay callback. Work it does during a prompt is drawn on the layer
+// selected before the prompt pushed its overlay, which outlives the prompt.
+void CDisplay::CallbackDelay(const uint32_t delay_ms)
+{
+    uint8_t select = m_select;
+
+    if (m_prompt == true)
+    {
+        m_select = m_layer[m_layer_count].select;
+        m_draw = GetLayerUnit(m_select);
+    }
+
+    m_callback_delay(delay_ms);
+
+    m_select = select;
+    m_draw = GetLayerUnit(m_select);
+}
+
+
+uint8_t CDisplay::LevelFromBrightness(const Brightness brightness)
+{
+    // L1..L8 map onto the upper bound of each 32 level band
+    uint8_t value = static_cast<uint8_t>(brightness);
+    return (value == 0) ? 0 : (value * 32) - 1;
+}
+
+
+CDisplay::Brightness CDisplay::BrightnessFromLevel(const uint8_t level)
+{
+    return static_cast<Brightness>((level + 31) >> 5);
+}
+
+
+type_unit CDisplay::random_fast(const type_unit min, const type_unit max)
+{
+#if defined(USE_FASTLED) && defined(NDISPLAY_WIDE)
+    return random16(min, max); // FastLED implementation
+#elif defined(USE_FASTLED)
     return random8(min, max); // FastLED implementation
 #else
     return random(min, max); // Arduino implementation
@@ -37,11 +37,16 @@
 
 #include <avr/pgmspace.h>
 
+#include "nDisplayConfig.h"
+
 typedef uint8_t type_item;
 typedef const __FlashStringHelper* const type_array;
 
 class CDisplay
 {
+    friend class CDisplayMirror;
+    friend class CDisplayRegion;
+    
     public:
     
     enum status_t : bool
@@ -126,7 +131,7 @@ class CDisplay
         uint8_t item_count;
         Brightness brightness_min;
         Brightness brightness_max;
-        const uint8_t* item_position;
+        const type_unit* item_position;
         const uint8_t* item_digit_count;
         const type_item* item_lower_limit;
         const type_item* item_upper_limit;
@@ -141,8 +146,20 @@ class CDisplay
     {
         char value;
         Brightness brightness;
+        uint8_t level;
     } Unit;
     
+    typedef struct FadeStruct
+    {
+        type_unit unit;
+        uint8_t layer; // Layer the fade writes to
+        uint8_t level; // Last level written by fade
+        uint8_t level_start;
+        uint8_t level_target;
+        uint16_t elapsed;
+        uint16_t duration;
+    } Fade;
+    
     typedef struct DisplayStruct
     {
         DisplayStruct()
@@ -152,15 +169,42 @@ class CDisplay
             // empty
         }
         
-        uint8_t unit_count;
+        type_unit unit_count;
         Unit* unit;
     } Display;
     
+    typedef struct LayerStruct
+    {
+        LayerStruct()
+            : unit{nullptr}
+            , mask{nullptr}
+            , select{0}
+        {
+            // empty
+        }
+        
+        Unit* unit; // Allocated on first push, kept for reuse
+        uint8_t* mask; // Bit set if unit is opaque
+        uint8_t select; // Layer selected before push
+    } Layer;
+    
+    static constexpr uint8_t LAYER_MAX = 3; // Overlays above base layer
+    
     protected:
-    Display m_display;
+    Display m_display; // Composited frame
+    Unit* m_draw; // Layer written by set and get methods
+    Layer m_layer[LAYER_MAX + 1];
+    uint8_t m_layer_count;
+    uint8_t m_select; // Index of m_draw
+    bool m_prompt; // Top overlay pushed by a prompt
+    Fade* m_fade; // At most one fade per unit and layer
+    uint16_t m_fade_count;
+    uint16_t m_fade_capacity;
     bool (*m_callback_is_increment)();
     bool (*m_callback_is_select)();
     bool (*m_callback_is_update)();
+    void (*m_callback_delay)(uint32_t);
+    uint32_t (*m_callback_time)(void);
     
     static constexpr auto default_parameter = [](Event event, uint8_t value) -> bool
     {
@@ -170,30 +214,64 @@ class CDisplay
     };
     
     public:
+    // Default input policy
+    struct InputCallback
+    {
+        static bool IsIncrement(CDisplay& display) { return display.IsInputIncrement(); }
+        static bool IsSelect(CDisplay& display) { return display.IsInputSelect(); }
+        static bool IsUpdate(CDisplay& display) { return display.IsInputUpdate(); }
+    };
+    
     // Constructor
-    CDisplay(const uint8_t unit_count);
+    CDisplay(const type_unit unit_count);
     ~CDisplay(void);
     
     // Set methods
-    status_t SetUnitValue(const uint8_t unit, const char character);
-    status_t SetUnitIndicator(const uint8_t unit, const bool state);
-    status_t SetUnitBrightness(const uint8_t unit, const Brightness brightness);
+    status_t SetUnitValue(const type_unit unit, const char character);
+    status_t SetUnitIndicator(const type_unit unit, const bool state);
+    status_t SetUnitBrightness(const type_unit unit, const Brightness brightness);
     status_t SetDisplayValue(const char* string);
     status_t SetDisplayValue(const __FlashStringHelper* string);
     status_t SetDisplayValue(const uint32_t value);
     status_t SetDisplayIndicator(const bool state);
     status_t SetDisplayBrightness(const Brightness brightness);
+    status_t SetUnitLevel(const type_unit unit, const uint8_t level);
+    status_t SetDisplayLevel(const uint8_t level);
+    status_t SetRangeValue(const type_unit unit, const char* string, const type_unit length);
+    status_t FillRangeValue(const type_unit unit, const type_unit length, const char character);
+    status_t ShiftRangeValue(const type_unit unit, const type_unit length, const Direction direction, const char* string, const type_unit count = 1);
+    status_t RotateRangeValue(const type_unit unit, const type_unit length, const Direction direction, const type_unit count = 1);
+    status_t ShiftDisplayValue(const Direction direction, const char* string, const type_unit count = 1);
+    status_t RotateDisplayValue(const Direction direction, const type_unit count = 1);
     
     void SetCallbackIsIncrement(bool (*function_ptr)(void)) { m_callback_is_increment = function_ptr; }
     void SetCallbackIsSelect(bool (*function_ptr)(void)) { m_callback_is_select = function_ptr; }
     void SetCallbackIsUpdate(bool (*function_ptr)(void)) { m_callback_is_update = function_ptr; }
+    void SetCallbackDelay(void (*function_ptr)(uint32_t)) { m_callback_delay = function_ptr; }
+    void SetCallbackTime(uint32_t (*function_ptr)(void)) { m_callback_time = function_ptr; }
     
     // Get methods
-    uint8_t GetUnitCount(void);
-    char GetUnitValue(const uint8_t unit);
-    bool GetUnitIndicator(const uint8_t unit);
-    Brightness GetUnitBrightness(const uint8_t unit);
+    type_unit GetUnitCount(void);
+    char GetUnitValue(const type_unit unit);
+    bool GetUnitIndicator(const type_unit unit);
+    Brightness GetUnitBrightness(const type_unit unit);
+    uint8_t GetUnitLevel(const type_unit unit);
+    uint8_t GetUnitDuty(const type_unit unit);
     status_t GetDisplayValue(char* string);
+    status_t GetRangeValue(const type_unit unit, char* string, const type_unit length);
+
+    // Layer methods
+    status_t PushOverlay(void);
+    status_t PopOverlay(void);
+    status_t SelectLayer(const uint8_t layer);
+    status_t SetOverlayMask(const type_unit unit, const bool opaque);
+    uint8_t GetOverlayCount(void) { return m_layer_count; }
+    void Flush(void);
+    
+    // Fade methods
+    status_t FadeUnitLevel(const type_unit unit, const uint8_t level, const uint16_t duration_ms);
+    status_t FadeDisplayLevel(const uint8_t level, const uint16_t duration_ms);
+    bool UpdateFade(const uint16_t elapsed_ms);
 
     // Effect methods
     void EffectScroll(const char* string, const Direction direction, const uint32_t delay_ms = 50);
@@ -203,41 +281,55 @@ class CDisplay
     void EffectStrobe(const uint8_t iteration = 10, const uint32_t delay_ms = 40);
         
     // Prompt methods
-    template<typename Functor = decltype(default_parameter)>
+    // Input policy is a compile-time parameter, e.g. PromptSelect<ButtonInput>(prompt),
+    // where ButtonInput provides static IsIncrement, IsSelect and IsUpdate methods
+    // taking a CDisplay reference. The default policy uses the registered callbacks.
+    // Timeouts are measured on the time callback (millis() by default), so they
+    // do not depend on how often the prompt polls or how long Yield() takes.
+    // PromptSelect times out after timeout * 30 ms. PromptValue blinks the
+    // current item every timeout / 16 ms and times out after 62 blinks.
+    // The blink fades between levels with FadeUnitLevel, and while waiting
+    // PromptValue advances all fades with UpdateFade, so fades started before
+    // the prompt keep running, also on blinked units as fades are kept per
+    // layer. Do not also advance them from a task meanwhile.
+    // While the delay callback runs, set and get methods address the layer
+    // selected before the prompt, so tasks keep drawing beneath the prompt.
+    template<typename Input = InputCallback, typename Functor = decltype(default_parameter)>
     int8_t PromptSelect(const PromptSelectStruct &prompt, const uint32_t timeout = 500, Functor functor = default_parameter)
     {
-        uint32_t timeout_count = timeout * 3000;
-        //uint32_t timeout_resolution = timeout_count / m_display.unit_count;
+        uint32_t timeout_ms = timeout * 30;
+        //uint32_t timeout_resolution = timeout_ms / m_display.unit_count;
         
-        Brightness brightness_copy[m_display.unit_count];
+        bool overlay = (PushOverlay() == STATUS_OK); // Preserve underlying frame
+        Unit frame[overlay ? 1 : m_display.unit_count]; // Fallback copy without overlay
+        BeginPrompt(overlay, frame);
 
         if (prompt.title != nullptr)
         {
             SetDisplayValue(prompt.title);
             EffectSlotMachine(10);
-            delay(1000);
+            Delay(1000);
         }
 
         Direction initial_direction = (prompt.display_mode == Mode::SCROLL) ? \
-            ((IsInputIncrement() ? Direction::LEFT : Direction::RIGHT)) : Direction::LEFT;
+            ((Input::IsIncrement(*this) ? Direction::LEFT : Direction::RIGHT)) : Direction::LEFT;
         
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
+        for (type_unit index = 0; index < m_display.unit_count; index++)
         {
             EffectScroll(" ", initial_direction, 25);
-            brightness_copy[index] = GetUnitBrightness(index);
         }
 
         uint8_t selection = prompt.initial_selection;
         EffectScroll(prompt.item_array[selection], initial_direction, 25);
 
-        uint32_t count = 0;
-        IsInputUpdate(); // Clear any pending update
+        uint32_t time_start = GetTime();
+        Input::IsUpdate(*this); // Clear any pending update
 
         do
         {
-            if (IsInputUpdate())
+            if (Input::IsUpdate(*this))
             {
-                if (IsInputIncrement())
+                if (Input::IsIncrement(*this))
                 {
                     selection += 1;
 
@@ -264,9 +356,9 @@ class CDisplay
 
                 if (prompt.display_mode == Mode::SCROLL)
                 {
-                    Direction direction = (IsInputIncrement() ? Direction::LEFT : Direction::RIGHT);
+                    Direction direction = (Input::IsIncrement(*this) ? Direction::LEFT : Direction::RIGHT);
 
-                    for (uint8_t index = 0; index < m_display.unit_count; index++)
+                    for (type_unit index = 0; index < m_display.unit_count; index++)
                     {
                         EffectScroll(" ", direction, 25);
                     }
@@ -276,9 +368,10 @@ class CDisplay
                 else
                 {
                     SetDisplayValue(prompt.item_array[selection]);
+                    Flush();
                 }
 
-                count = 0;
+                time_start = GetTime();
             }
             else
             {
@@ -286,61 +379,60 @@ class CDisplay
                 // Display "progress bar"
                 if (!(count % timeout_resolution))
                 {
-                    uint8_t position = (count / timeout_resolution);
+                    type_unit position = (count / timeout_resolution);
                     
-                    for (uint8_t index = 0; index < m_display.unit_count; index++)
+                    for (type_unit index = 0; index < m_display.unit_count; index++)
                     {
                         SetUnitIndicator(index, (index >= position));
                     }
                 }
                 */
                 
-                count++;
+                Yield();
                 
-                if (count > timeout_count)
+                if (GetTime() - time_start > timeout_ms)
                 {
                     if (functor(Event::TIMEOUT, selection)) //Check if we should reset timeout
                     {
-                        count = 0;
+                        time_start = GetTime();
                         continue;
                     }
                     
+                    EndPrompt(overlay, frame);
                     return -1; // Timeout
                 }
             }
-        } while (IsInputSelect() == false);
+        } while (Input::IsSelect(*this) == false);
 
         functor(Event::SELECTION, selection);
         SetDisplayBrightness(Brightness::MAX);
         EffectStrobe(10, 36);
-        delay(250);
-
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
-        {
-            SetUnitBrightness(index, brightness_copy[index]);
-        }
+        Delay(250);
 
+        EndPrompt(overlay, frame);
         return selection;
     }
     
-    template<typename Functor = decltype(default_parameter)>
+    template<typename Input = InputCallback, typename Functor = decltype(default_parameter)>
     int8_t PromptValue(const PromptValueStruct &prompt, const uint32_t timeout = 4000, Functor functor = default_parameter)
     {
        uint8_t item = 0;
+        uint32_t blink_ms = (timeout >= 16) ? (timeout / 16) : 1; // Half period
         char s[m_display.unit_count];
-        Brightness brightness_copy[m_display.unit_count];
+        bool overlay = (PushOverlay() == STATUS_OK); // Preserve underlying frame
+        Unit frame[overlay ? 1 : m_display.unit_count]; // Fallback copy without overlay
+        BeginPrompt(overlay, frame);
 
         if (prompt.title != nullptr)
         {
             SetDisplayValue(prompt.title);
             EffectSlotMachine(10);
-            delay(1000);
+            Delay(1000);
         }
 
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
+        for (type_unit index = 0; index < m_display.unit_count; index++)
         {
             EffectScroll(" ", Direction::LEFT, 25);
-            brightness_copy[index] = GetUnitBrightness(index);
         }
 
         EffectScroll(prompt.initial_display, Direction::LEFT, 25);
@@ -348,7 +440,9 @@ class CDisplay
 
         do
         {
-            uint32_t count = 0;
+            uint32_t time_start;
+            uint32_t time_fade;
+            uint32_t blink = 0;
 
             if (prompt.alphabetic == true)
             {
@@ -365,13 +459,16 @@ class CDisplay
                 SetUnitBrightness(prompt.item_position[item] + index, prompt.brightness_max);
             }
 
-            IsInputUpdate(); // Clear any pending update
+            Flush();
+            time_start = GetTime();
+            time_fade = time_start;
+            Input::IsUpdate(*this); // Clear any pending update
             
             do
             {
-                if (IsInputUpdate())
+                if (Input::IsUpdate(*this))
                 {
-                    if (IsInputIncrement())
+                    if (Input::IsIncrement(*this))
                     {
                         prompt.item_value[item] += 1;
 
@@ -416,39 +513,53 @@ class CDisplay
                         SetUnitBrightness(prompt.item_position[item] + index, prompt.brightness_max);
                     }
 
-                    count = 0;
+                    Flush();
+                    time_start = GetTime();
+                    blink = 0;
                 }
                 else
                 {
-                    count++;
+                    Yield();
 
-                    if ((count % timeout) == 0)
+                    uint32_t time = GetTime();
+                    uint32_t elapsed = time - time_start;
+
+                    if (elapsed / blink_ms != blink)
                     {
+                        blink = elapsed / blink_ms;
+                        uint8_t level = LevelFromBrightness((blink % 2) ? prompt.brightness_max : prompt.brightness_min);
+
                         for (uint8_t index = 0; index < prompt.item_digit_count[item]; index++)
                         {
-                            SetUnitBrightness(prompt.item_position[item] + index, (((count / timeout) % 2) ? prompt.brightness_max : prompt.brightness_min));
+                            FadeUnitLevel(prompt.item_position[item] + index, level, blink_ms / 2);
                         }
                     }
 
-                    if (count > (timeout * 62))
+                    // Flushes while the prompt overlay is pushed
+                    UpdateFade((time - time_fade < 0xFFFF) ? (time - time_fade) : 0xFFFF);
+                    time_fade = time;
+
+                    if (elapsed > (blink_ms * 62))
                     {
                         if (functor(Event::TIMEOUT, prompt.item_value[item])) //Check if we should reset timeout
                         {
-                            count = 0;
+                            time_start = GetTime();
+                            blink = 0;
                             continue;
                         }
                         
-                        for (uint8_t index = 0; index < m_display.unit_count; index++)
-                        {
-                            SetUnitBrightness(index, brightness_copy[index]);
-                        }
+                        EndPrompt(overlay, frame);
 
                         return -1; // Timeout
                     }
                 }
-            } while (IsInputSelect() == false);
+            } while (Input::IsSelect(*this) == false);
             
-            while (IsInputSelect() == true); // Wait while button pressed
+            while (Input::IsSelect(*this) == true) // Wait while button pressed
+            {
+                Yield();
+            }
+
             functor(Event::SELECTION, prompt.item_value[item]);
 
             for (uint8_t index = 0; index < prompt.item_digit_count[item]; index++)
@@ -460,13 +571,9 @@ class CDisplay
 
         SetDisplayBrightness(Brightness::MAX);
         EffectStrobe(10, 36);
-        delay(250);
-
-        for (uint8_t index = 0; index < m_display.unit_count; index++)
-        {
-            SetUnitBrightness(index, brightness_copy[index]);
-        }
+        Delay(250);
 
+        EndPrompt(overlay, frame);
         return 0; // OK
     }
     
@@ -475,13 +582,25 @@ class CDisplay
     bool IsInputIncrement(void);
     bool IsInputSelect(void);
     bool IsInputUpdate(void);
+    void Delay(const uint32_t delay_ms);
+    void Yield(void);
+    uint32_t GetTime(void);
+    void BeginPrompt(const bool overlay, Unit* frame);
+    void EndPrompt(const bool overlay, const Unit* frame);
+    
+    // Convert between Brightness and 256-level brightness
+    static uint8_t LevelFromBrightness(const Brightness brightness);
+    static Brightness BrightnessFromLevel(const uint8_t level);
     
     // Choose either Arduino or FastLED random implementation
-    static uint8_t random_fast(const uint8_t min, const uint8_t max);
+    static type_unit random_fast(const type_unit min, const type_unit max);
     
     private:
+    Unit* GetLayerUnit(const uint8_t layer) { return (m_layer_count == 0) ? m_display.unit : m_layer[layer].unit; }
+    void CallbackDelay(const uint32_t delay_ms);
+    
     // Initialize display
-    void Initialize(const uint8_t unit_count);
+    void Initialize(const type_unit unit_count);
 };
 
 #endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayConfig.h
+ * @summary     Generic Display build configuration
+ * @version     3.3
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _DISPLAY_CONFIG_H_
+#define _DISPLAY_CONFIG_H_
+
+// Options that change the layout of CDisplay. They are set in this file,
+// which the library sources and sketches both include, because a #define
+// in a sketch does not reach the library build.
+
+// Uncomment for displays with more than 255 units
+//#define NDISPLAY_WIDE
+
+#ifdef NDISPLAY_WIDE
+typedef uint16_t type_unit;
+#else
+typedef uint8_t type_unit;
+#endif
+
+#endif
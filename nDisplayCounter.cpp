@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayCounter.cpp
+ * @summary     Incremental BCD counter display
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#include "nDisplayCounter.h"
+
+
+CDisplayCounter::CDisplayCounter(CDisplay& display, const type_unit unit, const uint8_t digit_count)
+    : m_display(display)
+    , m_unit{unit}
+    , m_digit_count{0}
+    , m_bcd{nullptr}
+    , m_group_length{nullptr}
+    , m_group_limit{nullptr}
+{
+    // Counter must lie within display
+    if (static_cast<uint32_t>(unit) + digit_count <= display.GetUnitCount())
+    {
+        m_bcd = new uint8_t[(digit_count + 1) / 2 + 2 * digit_count];
+
+        if (m_bcd != nullptr)
+        {
+            m_group_length = m_bcd + (digit_count + 1) / 2;
+            m_group_limit = m_group_length + digit_count;
+            m_digit_count = digit_count;
+            memset(m_bcd, 0, (digit_count + 1) / 2);
+            memset(m_group_length, 1, digit_count);
+            memset(m_group_limit, 9, digit_count);
+
+            for (uint8_t digit = 0; digit < digit_count; digit++)
+            {
+                m_display.SetUnitValue(unit + digit, '0'); // Show initial value
+            }
+        }
+    }
+}
+
+
+CDisplayCounter::~CDisplayCounter(void)
+{
+    delete[] m_bcd;
+}
+
+
+// Combine digit and the digit above it into one group when length is 2
+CDisplayCounter::status_t CDisplayCounter::SetGroup(const uint8_t digit, const uint8_t length, const uint8_t limit)
+{
+    if ((length == 0) || (length > 2) || (static_cast<uint16_t>(digit) + length > m_digit_count))
+    {
+        return CDisplay::STATUS_ERROR;
+    }
+
+    if ((m_group_length[digit] == 0) || (limit > ((length == 1) ? 9 : 99)))
+    {
+        return CDisplay::STATUS_ERROR; // Digit belongs to group below
+    }
+
+    if (m_group_length[digit] == 2)
+    {
+        m_group_length[digit + 1] = 1; // Split previous group
+        m_group_limit[digit + 1] = 9;
+    }
+
+    if ((length == 2) && (m_group_length[digit + 1] == 2))
+    {
+        return CDisplay::STATUS_ERROR; // Overlaps group above
+    }
+
+    m_group_length[digit] = length;
+    m_group_limit[digit] = limit;
+
+    if (length == 2)
+    {
+        m_group_length[digit + 1] = 0;
+    }
+
+    if (GetGroup(digit) > limit)
+    {
+        SetGroupValue(digit, limit); // Clamp value to new limit
+    }
+
+    return CDisplay::STATUS_OK;
+}
+
+
+CDisplayCounter::status_t CDisplayCounter::SetValue(const uint32_t value)
+{
+    if (m_digit_count == 0)
+    {
+        return CDisplay::STATUS_ERROR;
+    }
+
+    memset(m_bcd, 0, (m_digit_count + 1) / 2);
+
+    for (uint8_t digit = 0; digit < m_digit_count; digit++)
+    {
+        m_display.SetUnitValue(m_unit + m_digit_count - digit - 1, '0');
+    }
+
+    Add(value);
+    return CDisplay::STATUS_OK;
+}
+
+
+uint8_t CDisplayCounter::GetDigit(const uint8_t digit)
+{
+    if (digit < m_digit_count)
+    {
+        return (m_bcd[digit >> 1] >> ((digit & 1) << 2)) & 0x0F;
+    }
+
+    return 0;
+}
+
+
+// Value in units of the lowest group, e.g. seconds for a clock
+uint32_t CDisplayCounter::GetValue(void)
+{
+    uint32_t value = 0;
+
+    for (uint8_t digit = m_digit_count; digit > 0; digit--)
+    {
+        uint8_t group = digit - 1;
+
+        if (m_group_length[group] != 0)
+        {
+            value = (value * (m_group_limit[group] + 1)) + GetGroup(group);
+        }
+    }
+
+    return value;
+}
+
+
+void CDisplayCounter::Increment(void)
+{
+    uint8_t digit = 0;
+
+    while (digit < m_digit_count)
+    {
+        uint8_t value = GetGroup(digit);
+
+        if (value < m_group_limit[digit])
+        {
+            SetGroupValue(digit, value + 1);
+            return;
+        }
+
+        SetGroupValue(digit, 0); // Carry into next group
+        digit += m_group_length[digit];
+    }
+}
+
+
+void CDisplayCounter::Decrement(void)
+{
+    uint8_t digit = 0;
+
+    while (digit < m_digit_count)
+    {
+        uint8_t value = GetGroup(digit);
+
+        if (value > 0)
+        {
+            SetGroupValue(digit, value - 1);
+            return;
+        }
+
+        SetGroupValue(digit, m_group_limit[digit]); // Borrow from next group
+        digit += m_group_length[digit];
+    }
+}
+
+
+void CDisplayCounter::Add(uint32_t value)
+{
+    uint8_t digit = 0;
+
+    while ((value > 0) && (digit < m_digit_count))
+    {
+        uint8_t radix = m_group_limit[digit] + 1;
+        uint8_t sum = GetGroup(digit) + (value % radix);
+
+        value /= radix;
+
+        if (sum >= radix)
+        {
+            sum -= radix;
+            value++;
+        }
+
+        SetGroupValue(digit, sum);
+        digit += m_group_length[digit];
+    }
+}
+
+
+uint8_t CDisplayCounter::GetGroup(const uint8_t digit)
+{
+    if (m_group_length[digit] == 2)
+    {
+        return (GetDigit(digit + 1) * 10) + GetDigit(digit);
+    }
+
+    return GetDigit(digit);
+}
+
+
+void CDisplayCounter::SetGroupValue(const uint8_t digit, const uint8_t value)
+{
+    if (m_group_length[digit] == 2)
+    {
+        SetDigit(digit, value % 10);
+        SetDigit(digit + 1, value / 10);
+    }
+    else
+    {
+        SetDigit(digit, value);
+    }
+}
+
+
+// Update digit and its unit only if changed
+void CDisplayCounter::SetDigit(const uint8_t digit, const uint8_t value)
+{
+    uint8_t shift = (digit & 1) << 2;
+    uint8_t& bcd = m_bcd[digit >> 1];
+
+    if (((bcd >> shift) & 0x0F) != value)
+    {
+        bcd = (bcd & ~(0x0F << shift)) | (value << shift);
+        m_display.SetUnitValue(m_unit + m_digit_count - digit - 1, '0' + value);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayCounter.h
+ * @summary     Incremental BCD counter display
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _DISPLAY_COUNTER_H_
+#define _DISPLAY_COUNTER_H_
+
+#include "nDisplay.h"
+
+// Counter shown on units [unit, unit + digit_count) of a CDisplay, starting
+// at 0 which the constructor writes to the units. The value is kept in packed
+// BCD, digit 0 being the rightmost unit. Increment, decrement and add ripple
+// carries only through the affected digits and rewrite only the units that
+// change.
+//
+// Digits form groups of 1 or 2 digits which wrap at a limit, 9 by default.
+// For a HHMMSS clock use a 6-digit counter with SetGroup(0, 2, 59),
+// SetGroup(2, 2, 59) and SetGroup(4, 2, 23). A group value above a new limit
+// is clamped to it.
+class CDisplayCounter
+{
+    public:
+    
+    typedef CDisplay::status_t status_t;
+    
+    protected:
+    CDisplay& m_display;
+    type_unit m_unit;
+    uint8_t m_digit_count;
+    uint8_t* m_bcd;
+    uint8_t* m_group_length; // 0 for second digit of a group
+    uint8_t* m_group_limit;
+    
+    public:
+    // Constructor
+    CDisplayCounter(CDisplay& display, const type_unit unit, const uint8_t digit_count);
+    ~CDisplayCounter(void);
+    
+    // Set methods
+    status_t SetGroup(const uint8_t digit, const uint8_t length, const uint8_t limit);
+    status_t SetValue(const uint32_t value);
+    
+    // Get methods
+    uint8_t GetDigitCount(void) { return m_digit_count; }
+    uint8_t GetDigit(const uint8_t digit);
+    uint32_t GetValue(void);
+    
+    // Counter methods
+    void Increment(void);
+    void Decrement(void);
+    void Add(uint32_t value);
+    
+    private:
+    uint8_t GetGroup(const uint8_t digit);
+    void SetGroupValue(const uint8_t digit, const uint8_t value);
+    void SetDigit(const uint8_t digit, const uint8_t value);
+};
+
+#endif
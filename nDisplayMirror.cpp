@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayMirror.cpp
+ * @summary     Display mirroring protocol encoder
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#include "nDisplayMirror.h"
+
+
+CDisplayMirror::CDisplayMirror(CDisplay& display, Print& output, const uint8_t keyframe_interval)
+    : m_source(display)
+    , m_output(output)
+    , m_sequence{0}
+    , m_checksum{0}
+    , m_keyframe_interval{keyframe_interval}
+    , m_delta_count{0}
+    , m_keyframe{true}
+    , m_packet_bytes{0}
+    , m_byte_count{0}
+    , m_packet_count{0}
+{
+    // Same layout as the frame so unchanged blocks compare with memcmp
+    m_shadow = new CDisplay::Unit[m_source.m_display.unit_count];
+}
+
+
+CDisplayMirror::~CDisplayMirror(void)
+{
+    delete[] m_shadow;
+}
+
+
+uint32_t CDisplayMirror::Update(void)
+{
+    const CDisplay::Unit* unit = m_source.m_display.unit;
+    type_unit unit_count = m_source.m_display.unit_count;
+    bool keyframe = m_keyframe || (m_delta_count >= m_keyframe_interval);
+    uint32_t index = 0; // Block skip may step past type_unit range
+
+    if (m_shadow == nullptr)
+    {
+        return 0;
+    }
+
+    if (!keyframe)
+    {
+        // Skip packet if nothing changed
+        while ((index < unit_count) && IsBlockEqual(index))
+        {
+            index += BLOCK_SIZE;
+        }
+
+        if (index >= unit_count)
+        {
+            return 0;
+        }
+    }
+
+    m_packet_bytes = 0;
+    Write(CMirrorDecoder::SYNC);
+    m_checksum = 0; // Checksum starts after sync
+
+    if (keyframe)
+    {
+        Write(CMirrorDecoder::TYPE_KEYFRAME);
+        Write(m_sequence);
+        WriteVarint(unit_count);
+        WriteValue(0, unit_count);
+        index = 0;
+
+        while (index < unit_count)
+        {
+            type_unit start = index;
+
+            while ((index < unit_count) && (unit[index].level == unit[start].level))
+            {
+                index++;
+            }
+
+            WriteLevel(start, index - start, unit[start].level);
+        }
+
+        m_keyframe = false;
+        m_delta_count = 0;
+    }
+    else
+    {
+        Write(CMirrorDecoder::TYPE_DELTA);
+        Write(m_sequence);
+        index = 0;
+
+        // Changed value runs, merging runs separated by short gaps
+        while (index < unit_count)
+        {
+            if (((index % BLOCK_SIZE) == 0) && IsBlockEqual(index))
+            {
+                index += BLOCK_SIZE;
+                continue;
+            }
+
+            if (unit[index].value == m_shadow[index].value)
+            {
+                index++;
+                continue;
+            }
+
+            type_unit start = index;
+            type_unit end = index + 1;
+
+            for (index = end; (index < unit_count) && (index - end < MERGE_GAP); index++)
+            {
+                if (unit[index].value != m_shadow[index].value)
+                {
+                    end = index + 1;
+                }
+            }
+
+            WriteValue(start, end - start);
+            index = end;
+        }
+
+        index = 0;
+
+        // Changed level runs, extended over neighbours of equal level
+        while (index < unit_count)
+        {
+            if (((index % BLOCK_SIZE) == 0) && IsBlockEqual(index))
+            {
+                index += BLOCK_SIZE;
+                continue;
+            }
+
+            if (unit[index].level == m_shadow[index].level)
+            {
+                index++;
+                continue;
+            }
+
+            type_unit start = index;
+
+            while ((index < unit_count) && (unit[index].level == unit[start].level))
+            {
+                index++;
+            }
+
+            WriteLevel(start, index - start, unit[start].level);
+        }
+
+        m_delta_count++;
+    }
+
+    Write(CMirrorDecoder::RECORD_END);
+    Write(m_checksum);
+    memcpy(m_shadow, unit, unit_count * sizeof(CDisplay::Unit));
+    m_sequence++;
+    m_packet_count++;
+    return m_packet_bytes;
+}
+
+
+void CDisplayMirror::Write(const uint8_t byte)
+{
+    m_output.write(byte);
+    m_checksum += byte;
+    m_packet_bytes++;
+    m_byte_count++;
+}
+
+
+void CDisplayMirror::WriteVarint(uint16_t value)
+{
+    while (value > 0x7F)
+    {
+        Write((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    Write(value);
+}
+
+
+void CDisplayMirror::WriteValue(const type_unit start, const type_unit length)
+{
+    const CDisplay::Unit* unit = m_source.m_display.unit;
+
+    Write(CMirrorDecoder::RECORD_VALUE);
+    WriteVarint(start);
+    WriteVarint(length);
+
+    for (uint32_t index = start; index < static_cast<uint32_t>(start) + length; index++)
+    {
+        Write(unit[index].value);
+    }
+}
+
+
+void CDisplayMirror::WriteLevel(const type_unit start, const type_unit length, const uint8_t level)
+{
+    Write(CMirrorDecoder::RECORD_LEVEL);
+    WriteVarint(start);
+    WriteVarint(length);
+    Write(level);
+}
+
+
+// Compare up to BLOCK_SIZE units from start with the last sent frame
+bool CDisplayMirror::IsBlockEqual(const type_unit start)
+{
+    type_unit unit_count = m_source.m_display.unit_count;
+    type_unit length = (unit_count - start < BLOCK_SIZE) ? (unit_count - start) : BLOCK_SIZE;
+
+    return (memcmp(&m_source.m_display.unit[start], &m_shadow[start], length * sizeof(CDisplay::Unit)) == 0);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayMirror.h
+ * @summary     Display mirroring protocol encoder
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _DISPLAY_MIRROR_H_
+#define _DISPLAY_MIRROR_H_
+
+#include "nDisplay.h"
+#include "nMirrorDecoder.h"
+
+// Encodes a CDisplay as keyframe and delta packets for a CMirrorDecoder.
+// See nMirrorDecoder.h for the packet layout.
+class CDisplayMirror
+{
+    protected:
+    
+    // Unchanged units between two changed runs are sent rather than
+    // starting a new record when the gap is shorter than this
+    static constexpr uint8_t MERGE_GAP = 3;
+    
+    // Units compared at once when skipping unchanged parts of the frame
+    static constexpr uint8_t BLOCK_SIZE = 8;
+    
+    CDisplay& m_source;
+    Print& m_output;
+    CDisplay::Unit* m_shadow; // Last sent frame
+    uint8_t m_sequence;
+    uint8_t m_checksum;
+    uint8_t m_keyframe_interval;
+    uint8_t m_delta_count;
+    bool m_keyframe;
+    uint32_t m_packet_bytes;
+    uint32_t m_byte_count;
+    uint32_t m_packet_count;
+    
+    public:
+    // Constructor
+    CDisplayMirror(CDisplay& display, Print& output, const uint8_t keyframe_interval = 32);
+    ~CDisplayMirror(void);
+    
+    // Send changes since the previous update. Returns bytes written.
+    uint32_t Update(void);
+    void RequestKeyframe(void) { m_keyframe = true; }
+    
+    // Get methods
+    uint32_t GetByteCount(void) { return m_byte_count; }
+    uint32_t GetPacketCount(void) { return m_packet_count; }
+    
+    private:
+    void Write(const uint8_t byte);
+    void WriteVarint(uint16_t value);
+    void WriteValue(const type_unit start, const type_unit length);
+    void WriteLevel(const type_unit start, const type_unit length, const uint8_t level);
+    bool IsBlockEqual(const type_unit start);
+};
+
+#endif
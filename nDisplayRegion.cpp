@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayRegion.cpp
+ * @summary     Display region with independent effects
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#include "nDisplayRegion.h"
+
+
+CDisplayRegion::CDisplayRegion(CDisplay& display, const type_unit unit, const type_unit unit_count)
+    : m_display(display)
+    , m_unit{unit}
+    , m_unit_count{0}
+    , m_effect{Effect::NONE}
+    , m_direction{Direction::LEFT}
+    , m_string{nullptr}
+    , m_string_length{0}
+    , m_step{0}
+    , m_step_count{0}
+    , m_delay_ms{0}
+    , m_elapsed{0}
+    , m_buffer{nullptr}
+{
+    // Region must lie within display
+    if (static_cast<uint32_t>(unit) + unit_count <= display.GetUnitCount())
+    {
+        m_buffer = new char[unit_count];
+
+        if (m_buffer != nullptr)
+        {
+            m_unit_count = unit_count;
+        }
+    }
+}
+
+
+CDisplayRegion::~CDisplayRegion(void)
+{
+    delete[] m_buffer;
+}
+
+
+CDisplayRegion::status_t CDisplayRegion::SetUnitValue(const type_unit unit, const char character)
+{
+    if (unit < m_unit_count)
+    {
+        return m_display.SetUnitValue(m_unit + unit, character);
+    }
+
+    return CDisplay::STATUS_ERROR;
+}
+
+
+CDisplayRegion::status_t CDisplayRegion::SetValue(const char* string)
+{
+    if (m_unit_count == 0)
+    {
+        return CDisplay::STATUS_ERROR; // Region failed construction
+    }
+
+    return m_display.SetRangeValue(m_unit, string, m_unit_count);
+}
+
+
+CDisplayRegion::status_t CDisplayRegion::SetValue(const uint32_t value)
+{
+    if (m_unit_count == 0)
+    {
+        return CDisplay::STATUS_ERROR; // Region failed construction
+    }
+
+    char s[m_unit_count];
+    uint32_t remain = value;
+
+    for (type_unit index = m_unit_count; index > 0; index--)
+    {
+        s[index - 1] = '0' + (remain % 10);
+        remain /= 10;
+    }
+
+    return SetValue(s);
+}
+
+
+char CDisplayRegion::GetUnitValue(const type_unit unit)
+{
+    if (unit < m_unit_count)
+    {
+        return m_display.GetUnitValue(m_unit + unit);
+    }
+
+    return 0;
+}
+
+
+CDisplayRegion::status_t CDisplayRegion::GetValue(char* string)
+{
+    if (m_unit_count == 0)
+    {
+        return CDisplay::STATUS_ERROR; // Region failed construction
+    }
+
+    return m_display.GetRangeValue(m_unit, string, m_unit_count);
+}
+
+
+// Starting an effect stops a running one first, so a slot machine or strobe
+// restores its target value before the new effect takes it
+void CDisplayRegion::EffectScroll(const char* string, const Direction direction, const uint32_t delay_ms)
+{
+    EffectStop();
+    m_string = string;
+    m_string_length = (string != nullptr) ? strlen(string) : 0;
+    m_direction = direction;
+    Start(Effect::SCROLL, m_string_length, delay_ms);
+}
+
+
+void CDisplayRegion::EffectSlotMachine(const uint32_t delay_ms)
+{
+    EffectStop();
+    GetValue(m_buffer); // Latch flags clear
+
+    // Iterate 3 times before latching one unit per cycle, 5 frames per cycle
+    Start(Effect::SLOT_MACHINE, (m_unit_count + 3UL) * 5, delay_ms);
+}
+
+
+void CDisplayRegion::EffectStrobe(const uint8_t iteration, const uint32_t delay_ms)
+{
+    EffectStop();
+    GetValue(m_buffer);
+    Start(Effect::STROBE, iteration + 1, delay_ms); // Final step restores value
+}
+
+
+void CDisplayRegion::EffectStop(void)
+{
+    if ((m_effect == Effect::SLOT_MACHINE) || (m_effect == Effect::STROBE))
+    {
+        SetValue(m_buffer); // Restore target value, latch flags masked
+    }
+
+    m_effect = Effect::NONE;
+}
+
+
+bool CDisplayRegion::Update(const uint32_t elapsed_ms)
+{
+    m_elapsed += elapsed_ms;
+
+    while ((m_effect != Effect::NONE) && (m_elapsed >= m_delay_ms))
+    {
+        m_elapsed -= m_delay_ms;
+        Step();
+    }
+
+    return (m_effect != Effect::NONE);
+}
+
+
+uint32_t CDisplayRegion::Task(void* context)
+{
+    CDisplayRegion* region = static_cast<CDisplayRegion*>(context);
+
+    if (region->Update(region->m_delay_ms))
+    {
+        return region->m_delay_ms;
+    }
+
+    return CScheduler::STOP;
+}
+
+
+void CDisplayRegion::Start(const Effect effect, const uint32_t step_count, const uint32_t delay_ms)
+{
+    m_effect = (m_unit_count > 0) ? effect : Effect::NONE;
+    m_step = 0;
+    m_step_count = step_count;
+    m_delay_ms = delay_ms;
+    m_elapsed = 0;
+
+    if (step_count == 0)
+    {
+        m_effect = Effect::NONE;
+    }
+
+    Step(); // First frame rendered immediately
+}
+
+
+void CDisplayRegion::Step(void)
+{
+    switch (m_effect)
+    {
+        case Effect::SCROLL:
+            if (m_direction == Direction::LEFT)
+            {
+                m_display.ShiftRangeValue(m_unit, m_unit_count, m_direction, m_string + m_step);
+            }
+            else
+            {
+                m_display.ShiftRangeValue(m_unit, m_unit_count, m_direction, m_string + m_string_length - m_step - 1);
+            }
+            break;
+
+        case Effect::SLOT_MACHINE:
+            if ((m_step % 5 == 0) && (m_step / 5 > 2))
+            {
+                type_unit index;
+
+                // Randomly select next unit to latch
+                do
+                {
+                    index = CDisplay::random_fast(0, m_unit_count);
+                } while (m_buffer[index] & 0x80);
+
+                m_buffer[index] |= 0x80;
+            }
+
+            for (type_unit index = 0; index < m_unit_count; index++)
+            {
+                if ((m_buffer[index] & 0x80) || (m_buffer[index] == ':'))
+                {
+                    m_display.SetUnitValue(m_unit + index, m_buffer[index]);
+                }
+                else
+                {
+                    m_display.SetUnitValue(m_unit + index, '0' + CDisplay::random_fast(0, 10));
+                }
+            }
+            break;
+
+        case Effect::STROBE:
+            if ((m_step % 2) || (m_step == m_step_count - 1))
+            {
+                SetValue(m_buffer);
+            }
+            else
+            {
+                m_display.FillRangeValue(m_unit, m_unit_count, ' ');
+            }
+            break;
+
+        case Effect::NONE:
+            break;
+    }
+
+    if (++m_step >= m_step_count)
+    {
+        m_effect = Effect::NONE;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nDisplayRegion.h
+ * @summary     Display region with independent effects
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _DISPLAY_REGION_H_
+#define _DISPLAY_REGION_H_
+
+#include "nDisplay.h"
+#include "nScheduler.h"
+
+// A window onto units [unit, unit + unit_count) of a CDisplay with its own
+// effect state. Effects do not block; Update() renders the frames that are
+// due, so several regions can animate in the same tick without touching
+// each other's units.
+class CDisplayRegion
+{
+    public:
+    
+    typedef CDisplay::status_t status_t;
+    typedef CDisplay::Direction Direction;
+    
+    enum class Effect : uint8_t
+    {
+        NONE,
+        SCROLL,
+        SLOT_MACHINE,
+        STROBE,
+    };
+    
+    protected:
+    CDisplay& m_display;
+    type_unit m_unit;
+    type_unit m_unit_count;
+    Effect m_effect;
+    Direction m_direction;
+    const char* m_string;
+    type_unit m_string_length;
+    uint32_t m_step;
+    uint32_t m_step_count;
+    uint32_t m_delay_ms;
+    uint32_t m_elapsed;
+    char* m_buffer; // Effect target, bit 7 marks latched unit
+    
+    public:
+    // Constructor
+    CDisplayRegion(CDisplay& display, const type_unit unit, const type_unit unit_count);
+    ~CDisplayRegion(void);
+    
+    // Set methods
+    status_t SetUnitValue(const type_unit unit, const char character);
+    status_t SetValue(const char* string);
+    status_t SetValue(const uint32_t value);
+    
+    // Get methods
+    type_unit GetUnitCount(void) { return m_unit_count; }
+    char GetUnitValue(const type_unit unit);
+    status_t GetValue(char* string);
+    
+    // Effect methods
+    // The scroll string must remain valid until the effect completes
+    void EffectScroll(const char* string, const Direction direction, const uint32_t delay_ms = 50);
+    void EffectSlotMachine(const uint32_t delay_ms = 10);
+    void EffectStrobe(const uint8_t iteration = 10, const uint32_t delay_ms = 40);
+    void EffectStop(void);
+    Effect GetEffect(void) { return m_effect; }
+    
+    // Advance effect by elapsed time. Returns true while effect is active.
+    bool Update(const uint32_t elapsed_ms);
+    
+    // CScheduler task rendering one frame per run, context is the region
+    static uint32_t Task(void* context);
+    
+    private:
+    void Start(const Effect effect, const uint32_t step_count, const uint32_t delay_ms);
+    void Step(void);
+};
+
+#endif
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nMirrorDecoder.cpp
+ * @summary     Display mirroring protocol decoder
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#include "nMirrorDecoder.h"
+#include <string.h>
+
+
+CMirrorDecoder::CMirrorDecoder(void)
+    : m_state{State::SYNC}
+    , m_type{0}
+    , m_record{0}
+    , m_sequence{0}
+    , m_packet_sequence{0}
+    , m_checksum{0}
+    , m_shift{0}
+    , m_synchronized{false}
+    , m_varint{0}
+    , m_start{0}
+    , m_length{0}
+    , m_unit_count{0}
+    , m_pending_count{0}
+    , m_capacity{0}
+    , m_pending_capacity{0}
+    , m_value{nullptr}
+    , m_level{nullptr}
+    , m_pending_value{nullptr}
+    , m_pending_level{nullptr}
+{
+    // empty
+}
+
+
+CMirrorDecoder::~CMirrorDecoder(void)
+{
+    delete[] m_value;
+    delete[] m_pending_value;
+}
+
+
+bool CMirrorDecoder::Decode(const uint8_t byte)
+{
+    if ((m_state != State::SYNC) && (m_state != State::CHECKSUM))
+    {
+        m_checksum += byte;
+    }
+
+    switch (m_state)
+    {
+        case State::SYNC:
+            if (byte == SYNC)
+            {
+                m_checksum = 0;
+                m_state = State::TYPE;
+            }
+            break;
+
+        case State::TYPE:
+            if ((byte == TYPE_KEYFRAME) || (byte == TYPE_DELTA))
+            {
+                m_type = byte;
+                m_state = State::SEQUENCE;
+            }
+            else
+            {
+                m_state = State::SYNC; // Not a packet start
+            }
+            break;
+
+        case State::SEQUENCE:
+            m_packet_sequence = byte;
+            m_varint = 0;
+            m_shift = 0;
+
+            if (m_type == TYPE_KEYFRAME)
+            {
+                m_state = State::UNIT_COUNT;
+            }
+            else if (m_synchronized && (byte == m_sequence) && AllocatePending(m_unit_count))
+            {
+                // Apply delta on top of current frame
+                m_pending_count = m_unit_count;
+                memcpy(m_pending_value, m_value, m_unit_count);
+                memcpy(m_pending_level, m_level, m_unit_count);
+                m_state = State::RECORD;
+            }
+            else
+            {
+                Desynchronize(); // Lost packet, wait for keyframe
+            }
+            break;
+
+        case State::UNIT_COUNT:
+            if (ReadVarint(byte))
+            {
+                if (AllocatePending(m_varint))
+                {
+                    m_pending_count = m_varint;
+                    memset(m_pending_value, ' ', m_pending_count);
+                    memset(m_pending_level, 0, m_pending_count);
+                    m_state = State::RECORD;
+                }
+                else
+                {
+                    Desynchronize();
+                }
+            }
+            break;
+
+        case State::RECORD:
+            m_varint = 0;
+            m_shift = 0;
+
+            if ((byte == RECORD_VALUE) || (byte == RECORD_LEVEL))
+            {
+                m_record = byte;
+                m_state = State::START;
+            }
+            else if (byte == RECORD_END)
+            {
+                m_state = State::CHECKSUM;
+            }
+            else
+            {
+                Desynchronize();
+            }
+            break;
+
+        case State::START:
+            if (ReadVarint(byte))
+            {
+                m_start = m_varint;
+                m_varint = 0;
+                m_shift = 0;
+                m_state = State::LENGTH;
+            }
+            break;
+
+        case State::LENGTH:
+            if (ReadVarint(byte))
+            {
+                m_length = m_varint;
+
+                if (static_cast<uint32_t>(m_start) + m_length > m_pending_count)
+                {
+                    Desynchronize(); // Record out of range
+                }
+                else if (m_record == RECORD_LEVEL)
+                {
+                    m_state = State::LEVEL;
+                }
+                else
+                {
+                    m_state = (m_length > 0) ? State::VALUE : State::RECORD;
+                }
+            }
+            break;
+
+        case State::VALUE:
+            m_pending_value[m_start++] = byte;
+
+            if (--m_length == 0)
+            {
+                m_state = State::RECORD;
+            }
+            break;
+
+        case State::LEVEL:
+            memset(m_pending_level + m_start, byte, m_length);
+            m_state = State::RECORD;
+            break;
+
+        case State::CHECKSUM:
+            if (byte == m_checksum)
+            {
+                uint8_t* ptr;
+                uint16_t capacity;
+
+                // Commit frame
+                ptr = m_value;
+                m_value = m_pending_value;
+                m_pending_value = ptr;
+                ptr = m_level;
+                m_level = m_pending_level;
+                m_pending_level = ptr;
+                capacity = m_capacity;
+                m_capacity = m_pending_capacity;
+                m_pending_capacity = capacity;
+
+                m_unit_count = m_pending_count;
+                m_sequence = m_packet_sequence + 1;
+                m_synchronized = true;
+                m_state = State::SYNC;
+                return true;
+            }
+
+            Desynchronize();
+            break;
+    }
+
+    return false;
+}
+
+
+char CMirrorDecoder::GetUnitValue(const uint16_t unit)
+{
+    if (unit < m_unit_count)
+    {
+        return m_value[unit] & 0x7F; // Mask indicator
+    }
+
+    return 0;
+}
+
+
+bool CMirrorDecoder::GetUnitIndicator(const uint16_t unit)
+{
+    if (unit < m_unit_count)
+    {
+        return m_value[unit] & 0x80;
+    }
+
+    return false;
+}
+
+
+uint8_t CMirrorDecoder::GetUnitLevel(const uint16_t unit)
+{
+    if (unit < m_unit_count)
+    {
+        return m_level[unit];
+    }
+
+    return 0;
+}
+
+
+bool CMirrorDecoder::ReadVarint(const uint8_t byte)
+{
+    if (m_shift > 14)
+    {
+        Desynchronize(); // Exceeds 16 bits
+        return false;
+    }
+
+    m_varint |= static_cast<uint16_t>(byte & 0x7F) << m_shift;
+    m_shift += 7;
+    return !(byte & 0x80);
+}
+
+
+// Only the pending buffer is resized, the committed frame stays intact
+// until a packet passes its checksum
+bool CMirrorDecoder::AllocatePending(const uint16_t unit_count)
+{
+    if (unit_count != m_pending_capacity)
+    {
+        delete[] m_pending_value;
+
+        // Value and level share one allocation per buffer
+        m_pending_value = new uint8_t[2 * unit_count];
+
+        if (m_pending_value == nullptr)
+        {
+            m_pending_level = nullptr;
+            m_pending_capacity = 0;
+            return false;
+        }
+
+        m_pending_level = m_pending_value + unit_count;
+        m_pending_capacity = unit_count;
+    }
+
+    return true;
+}
+
+
+void CMirrorDecoder::Desynchronize(void)
+{
+    m_synchronized = false;
+    m_state = State::SYNC;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nMirrorDecoder.h
+ * @summary     Display mirroring protocol decoder
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _MIRROR_DECODER_H_
+#define _MIRROR_DECODER_H_
+
+#include <stdint.h>
+
+// Packet layout:
+//   SYNC TYPE SEQUENCE [UNIT_COUNT] RECORD... END CHECKSUM
+//
+//   TYPE        TYPE_KEYFRAME carries the whole frame and UNIT_COUNT,
+//               TYPE_DELTA carries only units changed since the last packet
+//   RECORD      RECORD_VALUE START LENGTH VALUE[LENGTH]
+//               RECORD_LEVEL START LENGTH LEVEL (run of equal level)
+//   CHECKSUM    8-bit sum of all bytes from TYPE to END
+//
+// UNIT_COUNT, START and LENGTH are 7-bit varints. VALUE holds the character
+// in bits 0-6 and the indicator in bit 7. A delta is only applied on top of
+// the frame preceding it; after a lost or corrupt packet the decoder ignores
+// deltas until the next keyframe.
+//
+// The decoder has no Arduino dependencies so it can be built on the host.
+
+class CMirrorDecoder
+{
+    public:
+    
+    static constexpr uint8_t SYNC = 0xA5;
+    static constexpr uint8_t TYPE_KEYFRAME = 'K';
+    static constexpr uint8_t TYPE_DELTA = 'D';
+    static constexpr uint8_t RECORD_VALUE = 'V';
+    static constexpr uint8_t RECORD_LEVEL = 'L';
+    static constexpr uint8_t RECORD_END = 'E';
+    
+    protected:
+    
+    enum class State : uint8_t
+    {
+        SYNC,
+        TYPE,
+        SEQUENCE,
+        UNIT_COUNT,
+        RECORD,
+        START,
+        LENGTH,
+        VALUE,
+        LEVEL,
+        CHECKSUM,
+    };
+    
+    State m_state;
+    uint8_t m_type;
+    uint8_t m_record;
+    uint8_t m_sequence; // Expected sequence of next delta
+    uint8_t m_packet_sequence;
+    uint8_t m_checksum;
+    uint8_t m_shift;
+    bool m_synchronized;
+    uint16_t m_varint;
+    uint16_t m_start;
+    uint16_t m_length;
+    uint16_t m_unit_count;
+    uint16_t m_pending_count;
+    uint16_t m_capacity; // Units held by committed buffer
+    uint16_t m_pending_capacity; // Units held by pending buffer
+    uint8_t* m_value;
+    uint8_t* m_level;
+    uint8_t* m_pending_value;
+    uint8_t* m_pending_level;
+    
+    public:
+    // Constructor
+    CMirrorDecoder(void);
+    ~CMirrorDecoder(void);
+    
+    // Consume one byte of the stream. Returns true when a frame is complete.
+    bool Decode(const uint8_t byte);
+    
+    // Get methods
+    bool IsSynchronized(void) { return m_synchronized; }
+    uint16_t GetUnitCount(void) { return m_unit_count; }
+    char GetUnitValue(const uint16_t unit);
+    bool GetUnitIndicator(const uint16_t unit);
+    uint8_t GetUnitLevel(const uint16_t unit);
+    
+    private:
+    bool ReadVarint(const uint8_t byte);
+    bool AllocatePending(const uint16_t unit_count);
+    void Desynchronize(void);
+};
+
+#endif
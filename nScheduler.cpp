@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nScheduler.cpp
+ * @summary     Cooperative task scheduler
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#include "nScheduler.h"
+
+
+CScheduler::CScheduler(const uint8_t task_count)
+    : m_task{nullptr}
+    , m_task_count{0}
+    , m_head{TASK_INVALID}
+    , m_clock{nullptr}
+    , m_callback_idle{nullptr}
+{
+    // Allocate memory
+    m_task = new TaskEntry[task_count];
+
+    if (m_task != nullptr)
+    {
+        m_task_count = (task_count < TASK_INVALID) ? task_count : (TASK_INVALID - 1);
+    }
+}
+
+
+CScheduler::~CScheduler(void)
+{
+    delete[] m_task;
+}
+
+
+// Returns task id, or TASK_INVALID if no slot is free
+uint8_t CScheduler::AddTask(Task function, void* context, const uint32_t delay_ms)
+{
+    if (function == nullptr)
+    {
+        return TASK_INVALID;
+    }
+
+    for (uint8_t task = 0; task < m_task_count; task++)
+    {
+        TaskEntry& entry = m_task[task];
+
+        if ((entry.function == nullptr) && !entry.running)
+        {
+            entry.function = function;
+            entry.context = context;
+            entry.deadline = GetTime() + delay_ms;
+            entry.stats = TaskStats();
+            Insert(task);
+            return task;
+        }
+    }
+
+    return TASK_INVALID;
+}
+
+
+// A task may remove itself or another task while running
+bool CScheduler::RemoveTask(const uint8_t task)
+{
+    if ((task < m_task_count) && (m_task[task].function != nullptr))
+    {
+        if (!m_task[task].running)
+        {
+            Unlink(task);
+        }
+
+        m_task[task].function = nullptr;
+        return true;
+    }
+
+    return false;
+}
+
+
+CScheduler::TaskStats CScheduler::GetTaskStats(const uint8_t task)
+{
+    if (task < m_task_count)
+    {
+        return m_task[task].stats;
+    }
+
+    return TaskStats();
+}
+
+
+void CScheduler::ResetTaskStats(const uint8_t task)
+{
+    if (task < m_task_count)
+    {
+        m_task[task].stats = TaskStats();
+    }
+}
+
+
+bool CScheduler::Run(void)
+{
+    bool result = false;
+
+    // Bound iterations so tasks returning 0 cannot starve the caller
+    for (uint8_t count = 0; count < m_task_count; count++)
+    {
+        uint32_t time = GetTime();
+        uint8_t task = m_head;
+
+        // Earliest due task not already running further up the stack
+        while ((task != TASK_INVALID) && m_task[task].running)
+        {
+            task = m_task[task].next;
+        }
+
+        if ((task == TASK_INVALID) || (static_cast<int32_t>(time - m_task[task].deadline) < 0))
+        {
+            break;
+        }
+
+        TaskEntry& entry = m_task[task];
+        uint32_t latency = time - entry.deadline;
+
+        if ((entry.stats.run_count == 0) || (latency < entry.stats.latency_min))
+        {
+            entry.stats.latency_min = latency;
+        }
+
+        if (latency > entry.stats.latency_max)
+        {
+            entry.stats.latency_max = latency;
+        }
+
+        entry.stats.latency_sum += latency;
+        entry.stats.run_count++;
+
+        Unlink(task);
+        entry.running = true;
+        uint32_t interval = entry.function(entry.context);
+        entry.running = false;
+        result = true;
+
+        if ((interval == STOP) || (entry.function == nullptr))
+        {
+            entry.function = nullptr; // Free slot
+            continue;
+        }
+
+        // Keep period fixed, unless the task overran its next deadline
+        entry.deadline += interval;
+        time = GetTime();
+
+        if (static_cast<int32_t>(time - entry.deadline) > 0)
+        {
+            entry.deadline = time;
+        }
+
+        Insert(task);
+    }
+
+    return result;
+}
+
+
+void CScheduler::Delay(const uint32_t delay_ms)
+{
+    uint32_t start = GetTime();
+
+    while (true)
+    {
+        Run();
+
+        uint32_t time = GetTime();
+        uint32_t elapsed = time - start;
+
+        if (elapsed >= delay_ms)
+        {
+            break;
+        }
+
+        if (m_callback_idle != nullptr)
+        {
+            uint32_t idle = delay_ms - elapsed;
+            uint8_t task = m_head;
+
+            while ((task != TASK_INVALID) && m_task[task].running)
+            {
+                task = m_task[task].next;
+            }
+
+            if (task != TASK_INVALID)
+            {
+                int32_t remain = m_task[task].deadline - time;
+
+                if (remain <= 0)
+                {
+                    continue; // Task became due
+                }
+
+                if (static_cast<uint32_t>(remain) < idle)
+                {
+                    idle = remain;
+                }
+            }
+
+            m_callback_idle(idle);
+        }
+    }
+}
+
+
+uint32_t CScheduler::GetTime(void)
+{
+    return (m_clock != nullptr) ? m_clock() : millis();
+}
+
+
+// Insert task into list in deadline order, after tasks of equal deadline
+void CScheduler::Insert(const uint8_t task)
+{
+    uint8_t* link = &m_head;
+
+    while ((*link != TASK_INVALID) &&
+           (static_cast<int32_t>(m_task[*link].deadline - m_task[task].deadline) <= 0))
+    {
+        link = &m_task[*link].next;
+    }
+
+    m_task[task].next = *link;
+    *link = task;
+}
+
+
+void CScheduler::Unlink(const uint8_t task)
+{
+    uint8_t* link = &m_head;
+
+    while (*link != TASK_INVALID)
+    {
+        if (*link == task)
+        {
+            *link = m_task[task].next;
+            m_task[task].next = TASK_INVALID;
+            return;
+        }
+
+        link = &m_task[*link].next;
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 nitacku
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * @file        nScheduler.h
+ * @summary     Cooperative task scheduler
+ * @version     1.0
+ * @author      nitacku
+ * @data        15 July 2018
+ */
+
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+// Cooperative scheduler running tasks in deadline order. A task runs to
+// completion and returns the delay until its next run, or STOP. Blocking
+// code yields by calling Delay(), which runs due tasks while it waits;
+// pass it to CDisplay::SetCallbackDelay so effects and prompts yield
+// between frames:
+//
+//   display.SetCallbackDelay([](uint32_t ms) { scheduler.Delay(ms); });
+//   display.SetCallbackTime([]() { return scheduler.GetTime(); });
+//
+// SetClock and SetCallbackIdle allow a virtual clock, e.g. on a host build
+// where the idle callback advances time to the next deadline. Prompts and
+// whole-display effects are still blocking loops rather than tasks; they
+// only yield to the scheduler between frames and while waiting for input.
+class CScheduler
+{
+    public:
+    
+    typedef uint32_t (*Task)(void* context);
+    
+    static constexpr uint32_t STOP = 0xFFFFFFFF;
+    static constexpr uint8_t TASK_INVALID = 0xFF;
+    
+    struct TaskStats
+    {
+        TaskStats()
+            : run_count{0}
+            , latency_min{0}
+            , latency_max{0}
+            , latency_sum{0}
+        {
+            // empty
+        }
+        
+        uint32_t run_count;
+        uint32_t latency_min; // Time from deadline to start of run
+        uint32_t latency_max;
+        uint32_t latency_sum;
+    };
+    
+    protected:
+    
+    typedef struct TaskStruct
+    {
+        TaskStruct()
+            : function{nullptr}
+            , context{nullptr}
+            , deadline{0}
+            , next{TASK_INVALID}
+            , running{false}
+        {
+            // empty
+        }
+        
+        Task function;
+        void* context;
+        uint32_t deadline;
+        uint8_t next; // Next task in deadline order
+        bool running;
+        TaskStats stats;
+    } TaskEntry;
+    
+    TaskEntry* m_task;
+    uint8_t m_task_count;
+    uint8_t m_head;
+    uint32_t (*m_clock)();
+    void (*m_callback_idle)(uint32_t);
+    
+    public:
+    // Constructor
+    CScheduler(const uint8_t task_count);
+    ~CScheduler(void);
+    
+    // Task methods
+    uint8_t AddTask(Task function, void* context = nullptr, const uint32_t delay_ms = 0);
+    bool RemoveTask(const uint8_t task);
+    TaskStats GetTaskStats(const uint8_t task);
+    void ResetTaskStats(const uint8_t task);
+    
+    void SetClock(uint32_t (*function_ptr)(void)) { m_clock = function_ptr; }
+    void SetCallbackIdle(void (*function_ptr)(uint32_t)) { m_callback_idle = function_ptr; }
+    
+    // Time on the scheduler clock
+    uint32_t GetTime(void);
+    
+    // Run due tasks once. Returns true if any task ran.
+    bool Run(void);
+    
+    // Run due tasks until delay has elapsed
+    void Delay(const uint32_t delay_ms);
+    
+    private:
+    void Insert(const uint8_t task);
+    void Unlink(const uint8_t task);
+};
+
+#endif